@@ -0,0 +1,190 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <tuple>
+#include <SFML/Graphics/Image.hpp>
+
+#include <SfmlExt/atlas.hpp>
+
+// create frames with a random opaque block inside a transparent canvas
+std::vector<sfext::AtlasInput<int>> create_inputs(std::size_t num_frames, unsigned int size,
+	unsigned int max_w, unsigned int max_h, unsigned int seed) {
+	std::mt19937 rng{seed};
+	std::vector<sfext::AtlasInput<int>> inputs(num_frames);
+	for (auto i = 0u; i < num_frames; ++i) {
+		auto& input = inputs[i];
+		input.key = i;
+		input.origin = {size / 2.f, size / 2.f};
+		input.image.create(size, size, sf::Color::Transparent);
+		auto w = 1u + rng() % max_w;
+		auto h = 1u + rng() % max_h;
+		auto left = rng() % (size - w);
+		auto top = rng() % (size - h);
+		for (auto y = top; y < top + h; ++y) {
+			for (auto x = left; x < left + w; ++x) {
+				input.image.setPixel(x, y, sf::Color::White);
+			}
+		}
+	}
+	return inputs;
+}
+
+char const * to_string(sfext::PackingMode mode) {
+	switch (mode) {
+		case sfext::PackingMode::Scan: return "scan";
+		case sfext::PackingMode::MaxRects: return "maxrects";
+		case sfext::PackingMode::Skyline: return "skyline";
+		case sfext::PackingMode::Guillotine: return "guillotine";
+	}
+	return "unknown";
+}
+
+// settings and results of a single run
+struct Run {
+	std::string dataset, method;
+	sfext::PackingMode mode;
+	unsigned int min_step;
+	std::size_t size;
+	double ms;
+	std::size_t pages, failed;
+	double occupancy;      // used area relative to all pages
+	double bbox_occupancy; // used area relative to each page's used bounding box
+	double last_occupancy; // used area of the last page relative to its size
+	std::size_t wasted;
+};
+
+void print(Run const & run, bool first) {
+	std::cout << (first ? "\n" : ",\n")
+		<< "\t{\"dataset\": \"" << run.dataset << "\", \"method\": \"" << run.method
+		<< "\", \"mode\": \"" << to_string(run.mode) << "\", \"min_step\": " << run.min_step
+		<< ", \"size\": " << run.size << ", \"time_ms\": " << run.ms << ", \"pages\": " << run.pages
+		<< ", \"failed\": " << run.failed  << ", \"occupancy\": " << run.occupancy
+		<< ", \"bbox_occupancy\": " << run.bbox_occupancy << ", \"last_occupancy\": " << run.last_occupancy
+		<< ", \"wasted\": " << run.wasted << "}";
+}
+
+// pack all frames into pages of a fixed size: every frame beyond the
+// first page counts as a failed placement of a single atlas
+Run run_pages(sfext::AtlasGenerator<int>& generator, sfext::PackingMode mode, unsigned int min_step, std::size_t size) {
+	Run run;
+	run.method = "pages";
+	run.mode = mode;
+	run.min_step = min_step;
+	run.size = size;
+
+	sfext::MultiAtlas<int> atlas;
+	auto start = std::chrono::steady_clock::now();
+	generator.generatePages({min_step, min_step}, size, atlas, mode);
+	auto stop = std::chrono::steady_clock::now();
+	run.ms = std::chrono::duration<double, std::milli>(stop - start).count();
+
+	// duplicates would share their clipping
+	std::set<std::tuple<std::size_t, int, int>> used;
+	run.pages = atlas.pages.size();
+	std::vector<std::size_t> areas(run.pages, 0u);
+	std::vector<sf::Vector2i> extents(run.pages);
+	run.failed = 0u;
+	for (auto const & pair: atlas.frames) {
+		auto const & frame = pair.second;
+		auto const & clip = frame.clipping;
+		if (used.emplace(frame.page, clip.left, clip.top).second) {
+			areas[frame.page] += clip.width * clip.height;
+			auto& extent = extents[frame.page];
+			extent.x = std::max(extent.x, clip.left + clip.width);
+			extent.y = std::max(extent.y, clip.top + clip.height);
+		}
+		if (frame.page > 0u) {
+			++run.failed;
+		}
+	}
+	// the whole-pages figure only depends on the number of pages, so
+	// also relate the area to the part of each page which is in use
+	std::size_t area{0u}, bbox{0u};
+	for (auto i = 0u; i < run.pages; ++i) {
+		area += areas[i];
+		bbox += static_cast<std::size_t>(extents[i].x) * extents[i].y;
+	}
+	auto total = run.pages * size * size;
+	run.occupancy = total > 0u ? 100.0 * area / total : 0.0;
+	run.bbox_occupancy = bbox > 0u ? 100.0 * area / bbox : 0.0;
+	run.last_occupancy = run.pages > 0u ? 100.0 * areas.back() / (size * size) : 0.0;
+	run.wasted = total - area;
+	return run;
+}
+
+// pack all frames into the smallest single atlas
+Run run_minimal(sfext::AtlasGenerator<int>& generator, sfext::PackingMode mode, unsigned int min_step, std::size_t max_size) {
+	Run run;
+	run.method = "minimal";
+	run.mode = mode;
+	run.min_step = min_step;
+
+	sfext::Atlas<int> atlas;
+	auto start = std::chrono::steady_clock::now();
+	auto success = generator.generateMinimal({min_step, min_step}, max_size, atlas, mode);
+	auto stop = std::chrono::steady_clock::now();
+	run.ms = std::chrono::duration<double, std::milli>(stop - start).count();
+
+	std::size_t area{0u};
+	for (auto const & pair: atlas.frames) {
+		area += pair.second.clipping.width * pair.second.clipping.height;
+	}
+	auto size = atlas.image.getSize();
+	run.size = std::max(size.x, size.y);
+	run.pages = success ? 1u : 0u;
+	run.failed = success ? 0u : generator.getMemoryUsage().num_chunks;
+	auto total = static_cast<std::size_t>(size.x) * size.y;
+	run.occupancy = total > 0u ? 100.0 * area / total : 0.0;
+	// the atlas is cropped to its content
+	run.bbox_occupancy = run.occupancy;
+	run.last_occupancy = run.occupancy;
+	run.wasted = total - std::min(total, area);
+	return run;
+}
+
+int main(int argc, char** argv) {
+	std::size_t num_frames = argc > 1 ? std::stoul(argv[1]) : 500u;
+	std::string pattern = argc > 2 ? argv[2] : "data/human_melee_*.png";
+
+	// frame distributions
+	std::vector<std::pair<std::string, sfext::AtlasGenerator<int>>> datasets;
+	datasets.emplace_back("small", sfext::AtlasGenerator<int>{});
+	datasets.back().second.addBatch(create_inputs(num_frames, 64u, 32u, 32u, 42u));
+	datasets.emplace_back("mixed", sfext::AtlasGenerator<int>{});
+	datasets.back().second.addBatch(create_inputs(num_frames, 256u, 128u, 128u, 43u));
+	datasets.emplace_back("elongated", sfext::AtlasGenerator<int>{});
+	datasets.back().second.addBatch(create_inputs(num_frames, 128u, 100u, 16u, 44u));
+
+	std::vector<sfext::AtlasFile<int>> files;
+	for (auto const & filename: sfext::findFiles(pattern)) {
+		files.push_back({static_cast<int>(files.size()), filename, {32.f, 32.f}});
+	}
+	if (!files.empty()) {
+		datasets.emplace_back("human_melee", sfext::AtlasGenerator<int>{});
+		datasets.back().second.load(files);
+	}
+
+	std::cout << "[";
+	bool first{true};
+	for (auto& dataset: datasets) {
+		auto& generator = dataset.second;
+		std::vector<Run> runs;
+		for (auto min_step: {1u, 4u, 16u}) {
+			runs.push_back(run_pages(generator, sfext::PackingMode::Scan, min_step, 512u));
+		}
+		for (auto mode: {sfext::PackingMode::MaxRects, sfext::PackingMode::Skyline, sfext::PackingMode::Guillotine}) {
+			for (auto size: {256u, 512u, 1024u}) {
+				runs.push_back(run_pages(generator, mode, 1u, size));
+			}
+			runs.push_back(run_minimal(generator, mode, 1u, 8192u));
+		}
+		for (auto& run: runs) {
+			run.dataset = dataset.first;
+			print(run, first);
+			first = false;
+		}
+	}
+	std::cout << "\n]\n";
+}
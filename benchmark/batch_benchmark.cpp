@@ -0,0 +1,51 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <SFML/Graphics/Image.hpp>
+
+#include <SfmlExt/atlas.hpp>
+
+// create frames with a random opaque blob inside a transparent canvas
+std::vector<sfext::AtlasInput<int>> create_inputs(std::size_t num_frames, unsigned int size) {
+	std::mt19937 rng{42u};
+	std::vector<sfext::AtlasInput<int>> inputs(num_frames);
+	for (auto i = 0u; i < num_frames; ++i) {
+		auto& input = inputs[i];
+		input.key = i;
+		input.origin = {size / 2.f, size / 2.f};
+		input.image.create(size, size, sf::Color::Transparent);
+		auto w = 1u + rng() % (size / 2u);
+		auto h = 1u + rng() % (size / 2u);
+		auto left = rng() % (size - w);
+		auto top = rng() % (size - h);
+		for (auto y = top; y < top + h; ++y) {
+			for (auto x = left; x < left + w; ++x) {
+				input.image.setPixel(x, y, sf::Color::White);
+			}
+		}
+	}
+	return inputs;
+}
+
+int main(int argc, char** argv) {
+	std::size_t num_frames = argc > 1 ? std::stoul(argv[1]) : 2000u;
+	unsigned int size = argc > 2 ? std::stoul(argv[2]) : 256u;
+	
+	std::cout << "frames: " << num_frames << " (" << size << "x" << size << ")\n"
+		<< "threads\ttime [ms]\tspeedup\n";
+	double baseline{0.0};
+	for (auto num_threads: {1u, 2u, 4u, 8u, 12u, 16u}) {
+		auto inputs = create_inputs(num_frames, size);
+		sfext::AtlasGenerator<int> generator;
+		
+		auto start = std::chrono::steady_clock::now();
+		generator.addBatch(std::move(inputs), num_threads);
+		auto stop = std::chrono::steady_clock::now();
+		
+		auto ms = std::chrono::duration<double, std::milli>(stop - start).count();
+		if (num_threads == 1u) {
+			baseline = ms;
+		}
+		std::cout << num_threads << "\t" << ms << "\t" << baseline / ms << "\n";
+	}
+}
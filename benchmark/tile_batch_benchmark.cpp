@@ -0,0 +1,98 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <SFML/Graphics/View.hpp>
+
+#include <SfmlExt/tile_batch.hpp>
+#include <SfmlExt/tile_map.hpp>
+
+// create frames spread across two atlas pages
+sfext::FrameTable<int> create_frames(int num_frames, sf::Vector2i const & size) {
+	std::unordered_map<int, sfext::AtlasFrame> frames;
+	for (auto i = 0; i < num_frames; ++i) {
+		sfext::AtlasFrame frame{};
+		frame.clipping = {(i % 32) * size.x, (i / 32 % 32) * size.y, size.x, size.y};
+		frame.origin = {size.x / 2.f, size.y / 2.f};
+		frame.page = static_cast<std::size_t>(i % 2);
+		frame.rotated = i % 7 == 0;
+		frames[i] = frame;
+	}
+	return sfext::FrameTable<int>{frames};
+}
+
+template <sfext::GridMode M>
+void run(std::string const & name, sf::Vector2f const & tile_size, unsigned int map_size, std::size_t num_views) {
+	int const num_frames{256};
+	auto frames = create_frames(num_frames, sf::Vector2i{tile_size});
+	
+	// terrain layer is filled, object layer is sparse
+	sfext::TileMap<std::uint16_t, M> terrain{{map_size, map_size}}, objects{{map_size, map_size}};
+	std::mt19937 rng{7u};
+	for (auto y = 0u; y < map_size; ++y) {
+		for (auto x = 0u; x < map_size; ++x) {
+			terrain[{x, y}] = static_cast<std::uint16_t>(1u + rng() % num_frames);
+			objects[{x, y}] = rng() % 8u == 0u ? static_cast<std::uint16_t>(1u + rng() % num_frames) : 0u;
+		}
+	}
+	sfext::TileBatch<int, M> batch{frames, 2u, [&](sf::Vector2u const & pos, std::size_t layer, int& key) {
+		if (!terrain.contains(pos)) {
+			return false;
+		}
+		auto value = layer == 0u ? terrain[pos] : objects[pos];
+		key = value - 1;
+		return value != 0u;
+	}};
+	
+	sfext::Tiling<M> tiling{tile_size};
+	std::mt19937 view_rng{42u};
+	std::uniform_real_distribution<float> dist{0.f, static_cast<float>(map_size)};
+	std::vector<sf::View> views;
+	for (auto i = 0u; i < num_views; ++i) {
+		views.emplace_back(tiling.toScreen({dist(view_rng), dist(view_rng)}), sf::Vector2f{1920.f, 1080.f});
+	}
+	
+	// full rebuild per view
+	std::size_t num_quads{0u};
+	auto start = std::chrono::steady_clock::now();
+	for (auto const & view: views) {
+		tiling.setView(view);
+		batch.invalidate();
+		batch.update(tiling);
+		for (auto layer = 0u; layer < batch.getNumLayers(); ++layer) {
+			for (auto page = 0u; page < batch.getNumPages(); ++page) {
+				num_quads += batch.getLayer(layer, page).getVertexCount() / 4u;
+			}
+		}
+	}
+	auto middle = std::chrono::steady_clock::now();
+	
+	// camera scrolling by one pixel per frame: rebuilds only when crossing tiles
+	auto rebuilds = batch.getNumRebuilds();
+	auto view = views.front();
+	for (auto i = 0u; i < num_views; ++i) {
+		view.move(1.f, 0.f);
+		tiling.setView(view);
+		batch.update(tiling);
+	}
+	auto stop = std::chrono::steady_clock::now();
+	
+	auto rebuild_ms = std::chrono::duration<double, std::milli>(middle - start).count();
+	auto scroll_ms = std::chrono::duration<double, std::milli>(stop - middle).count();
+	std::cout << name << "\t" << num_quads / num_views << "\t" << rebuild_ms / num_views << "\t"
+		<< num_quads / rebuild_ms / 1000.0 << "\t" << scroll_ms / num_views << "\t"
+		<< batch.getNumRebuilds() - rebuilds << "\n";
+}
+
+int main(int argc, char** argv) {
+	unsigned int map_size = argc > 1 ? std::stoul(argv[1]) : 1024u;
+	std::size_t num_views = argc > 2 ? std::stoul(argv[2]) : 200u;
+	
+	std::cout << "map: " << map_size << "x" << map_size << ", views: " << num_views << " (1920x1080), 2 layers, 2 pages\n"
+		<< "grid\tquads\trebuild [ms]\tquads/us\tscroll [ms]\tscroll rebuilds\n";
+	run<sfext::GridMode::Orthogonal>("ortho", {16.f, 16.f}, map_size, num_views);
+	run<sfext::GridMode::IsoDiamond>("iso", {32.f, 16.f}, map_size, num_views);
+}
@@ -0,0 +1,80 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <SFML/Graphics/View.hpp>
+
+#include <SfmlExt/tile_map.hpp>
+
+struct Tile {
+	std::uint16_t terrain, object;
+};
+
+// create random camera views inside the map
+template <sfext::GridMode M>
+std::vector<sf::View> create_views(sfext::Tiling<M> const & tiling, unsigned int map_size, std::size_t num_views) {
+	std::mt19937 rng{42u};
+	std::uniform_real_distribution<float> dist{0.f, static_cast<float>(map_size)};
+	std::vector<sf::View> views;
+	for (auto i = 0u; i < num_views; ++i) {
+		auto center = tiling.toScreen({dist(rng), dist(rng)});
+		views.emplace_back(center, sf::Vector2f{1920.f, 1080.f});
+	}
+	return views;
+}
+
+template <sfext::GridMode M>
+void run(std::string const & name, sf::Vector2f const & tile_size, unsigned int map_size, std::size_t num_views) {
+	sfext::Tiling<M> tiling{tile_size};
+	auto views = create_views(tiling, map_size, num_views);
+
+	// row-major storage indexed with the tiling's positions
+	std::vector<Tile> row_major(static_cast<std::size_t>(map_size) * map_size);
+	sfext::TileMap<Tile, M> tile_map{{map_size, map_size}};
+	std::mt19937 rng{7u};
+	for (auto y = 0u; y < map_size; ++y) {
+		for (auto x = 0u; x < map_size; ++x) {
+			Tile tile{static_cast<std::uint16_t>(rng()), static_cast<std::uint16_t>(rng())};
+			row_major[static_cast<std::size_t>(y) * map_size + x] = tile;
+			tile_map[{x, y}] = tile;
+		}
+	}
+
+	std::uint64_t checksum[2] = {0u, 0u};
+	std::size_t num_tiles{0u};
+	auto start = std::chrono::steady_clock::now();
+	for (auto const & view: views) {
+		tiling.setView(view);
+		for (auto const & pos: tiling) {
+			if (pos.x < map_size && pos.y < map_size) {
+				checksum[0] += row_major[static_cast<std::size_t>(pos.y) * map_size + pos.x].terrain;
+				++num_tiles;
+			}
+		}
+	}
+	auto middle = std::chrono::steady_clock::now();
+	for (auto const & view: views) {
+		tiling.setView(view);
+		for (auto const & tile: tile_map.getVisible(tiling)) {
+			checksum[1] += tile.terrain;
+		}
+	}
+	auto stop = std::chrono::steady_clock::now();
+
+	auto row_ms = std::chrono::duration<double, std::milli>(middle - start).count();
+	auto map_ms = std::chrono::duration<double, std::milli>(stop - middle).count();
+	std::cout << name << "\t" << num_tiles << "\t" << row_ms << "\t" << map_ms << "\t" << row_ms / map_ms
+		<< (checksum[0] != checksum[1] ? "\tchecksum mismatch" : "") << "\n";
+}
+
+int main(int argc, char** argv) {
+	unsigned int map_size = argc > 1 ? std::stoul(argv[1]) : 4096u;
+	std::size_t num_views = argc > 2 ? std::stoul(argv[2]) : 200u;
+
+	std::cout << "map: " << map_size << "x" << map_size << ", views: " << num_views << " (1920x1080)\n"
+		<< "grid\ttiles\trow-major [ms]\ttile map [ms]\tspeedup\n";
+	run<sfext::GridMode::Orthogonal>("ortho", {16.f, 16.f}, map_size, num_views);
+	run<sfext::GridMode::IsoDiamond>("iso", {16.f, 8.f}, map_size, num_views);
+}
@@ -8,12 +8,15 @@
 // just a helper (see below)
 bool create_atlas(sfext::Atlas<int>& atlas) {
 	// Load images from disk and append to the atlas with an origin
-	sfext::AtlasGenerator<int> builder;
-	for (auto i = 0u; i < 5u; ++i) {
-		sf::Image img;
+	// note: images are decoded and shrinked concurrently
+	std::vector<sfext::AtlasFile<int>> files;
+	for (auto i = 0; i < 5; ++i) {
 		std::string fname{"data/human_melee_" + std::to_string(i) + ".png"};
-		img.loadFromFile(fname);
-		builder.add(i, std::move(img), {32.f, 32.f});
+		files.push_back({i, fname, {32.f, 32.f}});
+	}
+	sfext::AtlasGenerator<int> builder;
+	if (!builder.load(files).empty()) {
+		return false;
 	}
 
 	// Generate atlas image
@@ -1,6 +1,7 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/System.hpp>
 
+#include <SfmlExt/tile_batch.hpp>
 #include <SfmlExt/tiling.hpp>
 
 int main() {
@@ -22,9 +23,23 @@ int main() {
 	
 	// Prepare tileset
 	sf::Texture tileset;
-	sf::Sprite tile;
 	tileset.loadFromFile("data/tileset.png");
-	tile.setTexture(tileset);
+	std::unordered_map<int, sfext::AtlasFrame> frames;
+	frames[0] = {{0, 0, 64, 64}, {32.f, 32.f}, 0u, false, 0u, 0u};
+	frames[1] = {{64, 0, 64, 32}, {32.f, 16.f}, 0u, false, 0u, 0u};
+	sfext::FrameTable<int> frame_table{frames};
+	
+	// Prepare batches of 32x32 tile maps
+	sfext::TileBatch<int, sfext::GridMode::Orthogonal> ortho_batch{frame_table, 1u,
+		[](sf::Vector2u const & pos, std::size_t, int& key) {
+			key = 0;
+			return pos.x < 32 && pos.y < 32;
+		}};
+	sfext::TileBatch<int, sfext::GridMode::IsoDiamond> iso_batch{frame_table, 1u,
+		[](sf::Vector2u const & pos, std::size_t, int& key) {
+			key = 1;
+			return pos.x < 32 && pos.y < 32;
+		}};
 	
 	while (window.isOpen()) {
 		sf::Event event;
@@ -44,36 +59,20 @@ int main() {
 		if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left))		{ iso_cam.move(-4.f,  0.f); }
 		if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right))	{ iso_cam.move( 4.f,  0.f); }
 		
-		// update tiling views
+		// update tiling views and rebuild batches if necessary
 		ortho_tiling.setView(ortho_cam);
 		iso_tiling.setView(iso_cam);
+		ortho_batch.update(ortho_tiling);
+		iso_batch.update(iso_tiling);
 		
 		window.clear(sf::Color::Black);
 		// render ortho map
 		window.setView(ortho_cam);
-		tile.setTextureRect({0, 0, 64, 64});
-		tile.setOrigin({32.f, 32.f});
-		for (auto const & tile_pos: ortho_tiling) {
-			if (tile_pos.x < 32 && tile_pos.y < 32) {
-				auto spos = ortho_tiling.toScreen(static_cast<sf::Vector2f>(tile_pos));
-				// render tile
-				tile.setPosition(spos);
-				window.draw(tile);
-			}
-		}
+		window.draw(ortho_batch.getLayer(0u), &tileset);
 		
 		// render iso diamondmap
 		window.setView(iso_cam);
-		tile.setTextureRect({64, 0, 64, 32});
-		tile.setOrigin({32.f, 16.f});
-		for (auto const & tile_pos: iso_tiling) {
-			if (tile_pos.x < 32 && tile_pos.y < 32) {
-				auto spos = iso_tiling.toScreen(static_cast<sf::Vector2f>(tile_pos));
-				// render tile
-				tile.setPosition(spos);
-				window.draw(tile);
-			}
-		}
+		window.draw(iso_batch.getLayer(0u), &tileset);
 		
 		window.display();
 	}
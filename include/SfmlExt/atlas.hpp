@@ -1,8 +1,14 @@
 #pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string>
 #include <vector>
 #include <unordered_map>
 #include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SfmlExt/packing.hpp>
 
 namespace sfext {
 
@@ -13,32 +19,275 @@ class AtlasGenerator;
 template <typename Key>
 struct Chunk final {
 	Key key;
-	sf::Image image;
-	sf::IntRect bounds; // describe image rectangle (changed if shrinked)
+	sf::Image image; // shrinked pixels only
+	sf::IntRect bounds; // describe image rectangle (always at (0,0))
 	sf::IntRect target; // describes position inside atlas
+	bool rotated; // true if stored rotated by 90° clockwise
 	sf::Vector2f origin; // image's origin (changed if shrinked)
+	std::uint64_t hash; // hash of the shrinked pixels
+	std::vector<std::pair<Key, sf::Vector2f>> aliases; // keys and origins of duplicates
 		
 	/// Create a chunk
 	/**
 	 * @param key to identify the image with
-	 * @param image to use
-	 * @param bounds describing the image's source rectangle
+	 * @param image to move, already shrinked to its non-transparent pixels
 	 * @param origin describing the render origin for e.g. sf::Sprite
 	 */
-	Chunk(Key const & key, sf::Image&& image, sf::IntRect const & bounds, sf::Vector2f const & origin);
+	Chunk(Key const & key, sf::Image&& image, sf::Vector2f const & origin);
+};
+
+/// Image to be added to the atlas
+/**
+ * Used to add multiple images at once (see `AtlasGenerator::addBatch`).
+ */
+template <typename Key>
+struct AtlasInput {
+	Key key;
+	sf::Image image;
+	sf::Vector2f origin;
+};
+
+/// Image file to be added to the atlas
+/**
+ * Used to load multiple images at once (see `AtlasGenerator::load`).
+ */
+template <typename Key>
+struct AtlasFile {
+	Key key;
+	std::string filename;
+	sf::Vector2f origin;
 };
 
+/// Frame inside an atlas
+/**
+ * If `rotated` is set, the frame is stored rotated by 90° clockwise, so
+ * the clipping's width and height are swapped compared to the original
+ * image. Use `getTexCoords` to obtain the texture coordinates of the
+ * frame's corners in either case.
+ * If hulls were generated (see `AtlasGenerator::setHulls`), the frame's
+ * convex hull is given by `hull_size` vertices inside the atlas' `hulls`,
+ * starting at `hull_offset`. The vertices are relative to the frame's
+ * topleft corner in original (unrotated) orientation.
+ */
 struct AtlasFrame {
 	sf::IntRect clipping;
 	sf::Vector2f origin;
+	std::size_t page; // index of the atlas page (0 for single page atlases)
+	bool rotated; // true if stored rotated by 90° clockwise
+	std::uint32_t hull_offset, hull_size; // range of the convex hull's vertices
 };
 
+/// Determine texture coordinates of a frame's corners
+/**
+ * The corners are given in the order topleft, topright, bottomright and
+ * bottomleft of the original (unrotated) image. So they can be assigned
+ * to a quad's vertices without considering the frame's rotation.
+ * @param frame to query
+ * @return texture coordinates of all four corners
+ */
+std::array<sf::Vector2f, 4u> getTexCoords(AtlasFrame const & frame);
+
+/// Determine texture coordinates of a point inside a frame
+/**
+ * @param frame to query
+ * @param point relative to the frame's topleft corner in original orientation
+ * @return texture coordinates of the point
+ */
+sf::Vector2f getTexCoords(AtlasFrame const & frame, sf::Vector2f const & point);
+
+/// Append the triangles of a frame's convex hull
+/**
+ * The hull is triangulated as a fan. Each vertex is positioned relative
+ * to the frame's origin (like an `sf::Sprite` using that origin) and
+ * moved by `position`. The vertices are meant to be drawn as
+ * `sf::Triangles`. If the frame has no hull, its clipping rectangle is
+ * used instead.
+ * @param [out] vertices to append to
+ * @param frame to append
+ * @param hulls pointer to the atlas' hull vertices
+ * @param position to move the vertices by
+ * @param color of the vertices
+ */
+void appendHull(std::vector<sf::Vertex>& vertices, AtlasFrame const & frame, sf::Vector2f const * hulls,
+	sf::Vector2f const & position={}, sf::Color const & color=sf::Color::White);
+
+/// Determine how many transparent pixels a frame's hull avoids drawing
+/**
+ * @param frame to query
+ * @param hulls pointer to the atlas' hull vertices
+ * @return fraction of the clipping rectangle's area outside the hull
+ */
+float getOverdrawReduction(AtlasFrame const & frame, sf::Vector2f const * hulls);
+
 template <typename Key, typename HashFunc=std::hash<Key>>
 struct Atlas {
 	sf::Image image;
 	std::unordered_map<Key, AtlasFrame, HashFunc> frames;
+	std::vector<sf::Vector2f> hulls; // vertices of all frames' convex hulls
+};
+
+/// Atlas distributed across multiple pages
+/**
+ * Each frame's `page` determines the image holding the frame.
+ */
+template <typename Key, typename HashFunc=std::hash<Key>>
+struct MultiAtlas {
+	std::vector<sf::Image> pages;
+	std::unordered_map<Key, AtlasFrame, HashFunc> frames;
+	std::vector<sf::Vector2f> hulls; // vertices of all frames' convex hulls
 };
 
+/// Memory usage of an atlas generator
+/**
+ * All values are given in bytes and include the chunks' pixels and
+ * bookkeeping (see `AtlasGenerator::getMemoryUsage`).
+ */
+struct AtlasMemoryUsage {
+	std::size_t num_chunks; // number of stored (not merged) chunks
+	std::size_t current; // memory currently held by all chunks
+	std::size_t peak; // maximum memory held at once, including generated atlas images
+};
+
+/// Order in which frames are packed
+enum class SortOrder {
+	Area, MaxSide, Perimeter, Width, Height
+};
+
+/// Combination of packing strategy and order (see `AtlasGenerator::generateBest`)
+struct PackingHeuristic {
+	PackingMode mode;
+	SortOrder order;
+};
+
+/// Determine the bounding box of all non-transparent pixels
+/**
+ * The image's pixels are scanned once, row by row. Each row is only
+ * searched up to its first and back to its last non-transparent pixel.
+ * If available, SSE2 or AVX2 is used to test multiple pixels at once.
+ * @param image to scan
+ * @return bounding box or an empty rectangle if the image is fully transparent
+ */
+sf::IntRect getOpaqueBounds(sf::Image const & image);
+
+/// Copy a rectangular part of an image
+/**
+ * Rows are copied as a whole. If the rectangle is empty, an empty image
+ * is returned.
+ * @param image to copy from
+ * @param rect to copy (must be inside the image)
+ * @return image holding only the given rectangle
+ */
+sf::Image cropImage(sf::Image const & image, sf::IntRect const & rect);
+
+/// Copy a rectangular part of an image rotated by 90° clockwise
+/**
+ * The resulting image's width is the rectangle's height and vice versa.
+ * If the rectangle is empty, an empty image is returned.
+ * @param image to copy from
+ * @param rect to copy (must be inside the image)
+ * @return rotated image holding only the given rectangle
+ */
+sf::Image rotateImage(sf::Image const & image, sf::IntRect const & rect);
+
+/// Copy a rectangular part of an image into another image
+/**
+ * Unlike `sf::Image::copy`, rows are copied as a whole without blending
+ * and the pixels are written directly into the target image's storage.
+ * So blitting into non-overlapping areas of the same target image can be
+ * done by multiple threads at once.
+ * @param target image to write to
+ * @param pos topleft position inside the target image
+ * @param source image to copy from
+ * @param rect to copy (must be inside the source image)
+ * @param rotated if true, the rectangle is copied rotated by 90° clockwise
+ */
+void blitImage(sf::Image& target, sf::Vector2i const & pos, sf::Image const & source, sf::IntRect const & rect,
+	bool rotated=false);
+
+/// Replicate the edge pixels of a rectangle into its surrounding
+/**
+ * Each pixel of the surrounding border takes the color of the nearest
+ * pixel inside the rectangle. The border is clipped to the image. Like
+ * `blitImage`, non-overlapping areas can be processed by multiple threads.
+ * @param image to modify
+ * @param rect whose edges are replicated (must be inside the image)
+ * @param width of the border in pixels
+ */
+void extrudeEdges(sf::Image& image, sf::IntRect const & rect, unsigned int width);
+
+/// Create a chain of downsampled images
+/**
+ * Each level has half the size of the previous one (rounded down, at
+ * least one pixel) and is created using a 2x2 box filter, which is
+ * vectorized if SSE2 is available. Rows are filtered by multiple threads.
+ * Like GPU-generated mipmaps, the colors of transparent pixels are
+ * averaged as well; frames should therefore be surrounded by a gutter
+ * (see `AtlasGenerator::setGutter`), so sampling lower levels does not
+ * bleed into neighbouring frames.
+ * @param image to create the levels for (level 0)
+ * @param num_levels maximum number of levels to create, 0 to go down to 1x1
+ * @param num_threads number of threads, 0 for all hardware threads
+ * @return levels 1, 2, ... (excluding the given image)
+ */
+std::vector<sf::Image> createMipmaps(sf::Image const & image, std::size_t num_levels=0u, std::size_t num_threads=0u);
+
+/// Determine the convex hull of all non-transparent pixels
+/**
+ * The hull encloses all pixels' squares entirely. If it has more than
+ * `max_vertices` vertices, it is simplified by repeatedly removing the
+ * edge whose removal adds the least area, i.e. the neighbouring edges
+ * are extended until they meet. The hull never leaves the rectangle, so
+ * it might keep more vertices if no edge can be removed that way.
+ * @param image to scan
+ * @param rect to scan (must be inside the image)
+ * @param max_vertices maximum number of vertices (at least 3)
+ * @return vertices in clockwise order (on screen) relative to the rectangle's topleft corner
+ */
+std::vector<sf::Vector2f> getConvexHull(sf::Image const & image, sf::IntRect const & rect, std::size_t max_vertices);
+
+/// Calculate a hash of raw bytes
+/**
+ * The bytes are hashed using FNV-1a, so the hash does not depend on the
+ * platform or standard library. It can be continued by passing the
+ * previous result as initial hash.
+ * @param data bytes to hash
+ * @param size number of bytes
+ * @param hash initial hash value
+ * @return 64-bit hash value
+ */
+std::uint64_t hashBytes(void const * data, std::size_t size, std::uint64_t hash=14695981039346656037ull);
+
+/// Calculate a hash of an image's pixels
+/**
+ * The rectangle's size and all pixels inside it are hashed (FNV-1a).
+ * @param image to hash
+ * @param rect to hash (must be inside the image)
+ * @return 64-bit hash value
+ */
+std::uint64_t hashPixels(sf::Image const & image, sf::IntRect const & rect);
+
+/// Compare the pixels of two equally sized rectangles
+/**
+ * @param lhs first image
+ * @param lhs_rect rectangle inside the first image
+ * @param rhs second image
+ * @param rhs_rect rectangle inside the second image
+ * @param tolerance maximum difference per color channel
+ * @return true if all pixels' channels differ by at most `tolerance`
+ */
+bool comparePixels(sf::Image const & lhs, sf::IntRect const & lhs_rect, sf::Image const & rhs,
+	sf::IntRect const & rhs_rect, sf::Uint8 tolerance=0u);
+
+/// Find files matching a wildcard pattern
+/**
+ * The pattern's filename may contain `*` (any sequence of characters) and
+ * `?` (any single character), e.g. "data/human_melee_*.png". Directories
+ * are not matched by wildcards.
+ * @param pattern to search for
+ * @return sorted list of matching filenames (including the directory)
+ */
+std::vector<std::string> findFiles(std::string const & pattern);
+
 // ---------------------------------------------------------------------------
 
 /// Image Atlas Generator
@@ -54,19 +303,202 @@ template <typename Key>
 class AtlasGenerator final {
 	private:
 		std::vector<Chunk<Key>> chunks; // added chunks
+		bool deduplicate; // true if duplicates are merged
+		bool rotate; // true if chunks may be rotated
+		std::size_t max_hull_vertices; // 0 if no hulls are generated
+		bool align_blocks; // true if chunks are aligned to 4x4 blocks
+		unsigned int gutter; // border around each chunk
+		sf::Uint8 tolerance; // maximum difference per color channel for duplicates
+		std::unordered_multimap<std::uint64_t, std::size_t> lookup; // chunk indices by bucket
+		std::size_t memory, peak_memory; // bytes held by chunks
+		
+		/// Determine lookup bucket for duplicate search
+		std::uint64_t getBucket(Chunk<Key> const & chunk) const;
+		
+		/// Rebuild lookup of all chunks
+		void rebuildLookup();
+		
+		/// Shrink an image to the given bounds
+		/**
+		 * The image is only copied if the bounds do not cover it entirely.
+		 */
+		static void shrinkImage(sf::Image& image, sf::IntRect const & bounds);
+		
+		/// Create a chunk or merge it into a duplicate
+		/**
+		 * The image is expected to be shrinked already.
+		 */
+		void addChunk(Key const & key, sf::Image&& image, sf::Vector2f const & origin, std::uint64_t hash);
+		
+		/// Update peak memory usage while additional memory is held
+		void trackPeak(std::size_t extra);
+		
+		/// Sort chunks by size (descending, keeping the order of equal sizes)
+		void sortChunks();
+		
+		/// Create a packer for chunks
+		/**
+		 * If chunks are aligned to blocks, the minimum step is rounded up
+		 * to a multiple of the block size.
+		 */
+		std::unique_ptr<RectPacker> createChunkPacker(PackingMode mode, sf::Vector2u const & min_step) const;
 		
-		/// Check whether a row only holds transparent pixels
-		bool rowIsEmpty(sf::Image const & image, std::size_t row);
+		/// Target and rotation of a chunk
+		struct Placement {
+			sf::IntRect target;
+			bool rotated;
+		};
 		
-		/// Check whether a column only holds transparent pixels
-		bool colIsEmpty(sf::Image const & image, std::size_t col);
+		/// Determine a chunk's placement using the given packer
+		/**
+		 * The space of a chunk includes its gutter. If chunks are aligned
+		 * to blocks, it is rounded up to multiples of the block size.
+		 */
+		bool placeChunk(RectPacker& packer, Chunk<Key> const & chunk, Placement& placement) const;
+		
+		/// Place a chunk using the given packer
+		/**
+		 * The chunk's target and rotation are updated on success. The
+		 * space of a chunk includes its gutter. If chunks are aligned to
+		 * blocks, it is rounded up to multiples of the block size.
+		 */
+		bool insertChunk(RectPacker& packer, Chunk<Key>& chunk) const;
+		
+		/// Determine indices of all chunks in the given order (descending)
+		/**
+		 * Chunks with equal sort keys keep their current order.
+		 */
+		std::vector<std::size_t> getOrder(SortOrder order) const;
+		
+		/// Place all chunks into a bin of minimal size
+		/**
+		 * The chunks themselves are not modified, so multiple threads can
+		 * place them at once.
+		 * @param order indices of the chunks in packing order
+		 * @param mode packing strategy
+		 * @param min_step minimum step range for searching a free spot
+		 * @param max_size maximum size per dimension
+		 * @param [out] size of the bin
+		 * @param [out] placements per chunk
+		 * @return true if success, false if the chunks exceed the maximum size
+		 */
+		bool packMinimal(std::vector<std::size_t> const & order, PackingMode mode, sf::Vector2u const & min_step,
+			std::size_t max_size, sf::Vector2u& size, std::vector<Placement>& placements) const;
+		
+		/// Copy all placed chunks' pixels to their pages
+		/**
+		 * Chunks do not overlap, so they are copied in parallel. Gutters
+		 * are filled by extruding the chunks' edges.
+		 * @param pages to copy to
+		 * @param page_of page index per chunk (or empty if all chunks are on the first page)
+		 */
+		void blitChunks(std::vector<sf::Image*> const & pages, std::vector<std::size_t> const & page_of) const;
+		
+		/// Determine convex hulls of all chunks (if enabled)
+		/**
+		 * @param [out] hulls vertices of all hulls
+		 * @param [out] ranges offset and number of vertices per chunk
+		 */
+		void createHulls(std::vector<sf::Vector2f>& hulls,
+			std::vector<std::pair<std::uint32_t, std::uint32_t>>& ranges) const;
+		
+		/// Store frame of a chunk and all its duplicates
+		template <typename HashFunc>
+		void storeFrames(Chunk<Key> const & chunk, AtlasFrame frame, std::unordered_map<Key, AtlasFrame, HashFunc>& frames) const;
+		
+		/// Create atlas image and frames from placed chunks
+		template <typename HashFunc>
+		void createAtlas(sf::Vector2u const & size, Atlas<Key, HashFunc>& atlas) const;
 		
 	public:
+		/// Create an empty generator
+		AtlasGenerator();
+		
+		/// Enable or disable merging of duplicate frames
+		/**
+		 * If enabled, each added image is compared with all previously
+		 * added images (after shrinking). Duplicates are not stored again
+		 * but share the atlas region of the first image, while keeping
+		 * their own key and origin. By default, only identical pixels are
+		 * considered duplicates (using a hash of the pixels). A tolerance
+		 * can be given to also merge nearly identical images, where each
+		 * color channel differs by at most `tolerance`.
+		 * Duplicate merging is disabled by default.
+		 * @param enabled true to merge duplicates
+		 * @param tolerance maximum difference per color channel
+		 */
+		void setDeduplication(bool enabled, sf::Uint8 tolerance=0u);
+		
+		/// Enable or disable rotation of frames
+		/**
+		 * If enabled, the packer may store a frame rotated by 90°
+		 * clockwise if it fits better that way. This increases the packing
+		 * density for elongated frames. Rotated frames are marked by
+		 * `AtlasFrame::rotated` and need to be rendered with rotated texture
+		 * coordinates (see `getTexCoords`).
+		 * Rotation is disabled by default.
+		 * @param enabled true to allow rotation
+		 */
+		void setRotation(bool enabled);
+		
+		/// Enable or disable generation of convex hulls
+		/**
+		 * If enabled, a convex hull of each frame's non-transparent
+		 * pixels is generated (see `getConvexHull`). Drawing the hull's
+		 * triangles instead of the clipping rectangle reduces overdraw of
+		 * irregular shaped frames (see `appendHull`).
+		 * Hulls are disabled by default.
+		 * @param max_vertices maximum number of vertices per hull, 0 to disable
+		 */
+		void setHulls(std::size_t max_vertices);
+		
+		/// Enable or disable alignment of frames to 4x4 blocks
+		/**
+		 * If enabled, each frame starts at a multiple of 4 pixels and
+		 * occupies space rounded up to a multiple of 4 pixels. So no 4x4
+		 * block is shared by multiple frames, which prevents compression
+		 * artifacts bleeding between frames (see `compressImage`).
+		 * Alignment is disabled by default.
+		 * @param enabled true to align frames
+		 */
+		void setBlockAlignment(bool enabled);
+		
+		/// Set the width of the gutter around each frame
+		/**
+		 * Each frame is surrounded by a border of the given width, which
+		 * is filled with the frame's edge pixels (see `extrudeEdges`). So
+		 * filtered sampling and lower mipmap levels (see `createMipmaps`)
+		 * do not bleed into neighbouring frames: A gutter of `2^n` pixels
+		 * keeps `n` levels free of bleeding. If frames are aligned to
+		 * blocks, the gutter is rounded up to a multiple of 4 pixels.
+		 * There is no gutter by default.
+		 * @param width of the gutter in pixels
+		 */
+		void setGutter(unsigned int width);
+		
+		/// Get number of images which were merged as duplicates
+		/**
+		 * @return number of duplicates
+		 */
+		std::size_t getNumDuplicates() const;
+		
+		/// Get memory usage of the generator
+		/**
+		 * Each chunk only keeps its shrinked pixels, so mostly transparent
+		 * images require much less memory than their original size. The
+		 * peak usage also covers the atlas images while they are
+		 * generated. Temporarily decoded full-size images (see `load`)
+		 * are not included.
+		 * @return current and peak memory usage
+		 */
+		AtlasMemoryUsage getMemoryUsage() const;
+		
 		/// Try to add an image
 		/**
 		 * Creates a new chunk with `key` and the given `image`. The image
 		 * is shrinked to it's minimum size. This modifies the `origin` for
-		 * rendering with e.g. sf::Sprite.
+		 * rendering with e.g. sf::Sprite. A fully transparent image is
+		 * shrinked to an empty frame.
 		 * This always succeeds because the atlas itself is not generated here.
 		 * @param key used to identify the image
 		 * @param image should be moved to the atlas
@@ -74,6 +506,44 @@ class AtlasGenerator final {
 		 */
 		void add(Key const & key, sf::Image&& image, sf::Vector2f origin);
 		
+		/// Add multiple images at once
+		/**
+		 * Each image is shrinked like with `add`, but the images are
+		 * processed by a pool of worker threads. The resulting chunks are
+		 * appended in the order of the given range, so generating the atlas
+		 * is reproducible independent of the number of threads.
+		 * The images are moved out of the given range.
+		 * @param begin iterator to the first `AtlasInput<Key>`
+		 * @param end iterator behind the last `AtlasInput<Key>`
+		 * @param num_threads number of threads, 0 for all hardware threads
+		 */
+		template <typename Iter>
+		void addRange(Iter begin, Iter end, std::size_t num_threads=0u);
+		
+		/// Add multiple images at once
+		/**
+		 * @see `addRange`
+		 * @param inputs to move to the atlas
+		 * @param num_threads number of threads, 0 for all hardware threads
+		 */
+		void addBatch(std::vector<AtlasInput<Key>>&& inputs, std::size_t num_threads=0u);
+		
+		/// Load multiple image files
+		/**
+		 * The files are decoded concurrently by a pool of worker threads.
+		 * Each image is shrinked as soon as it was decoded, so only the
+		 * shrinked image is kept afterwards. At most `max_in_flight`
+		 * full-size images are held in memory at the same time. The chunks
+		 * are appended in the order of the given files, so generating the
+		 * atlas is reproducible.
+		 * @param files to load
+		 * @param max_in_flight maximum number of full-size images in memory
+		 * @param num_threads number of threads, 0 for all hardware threads
+		 * @return filenames of all files which could not be loaded
+		 */
+		std::vector<std::string> load(std::vector<AtlasFile<Key>> const & files,
+			std::size_t max_in_flight=8u, std::size_t num_threads=0u);
+		
 		/// Clears the entire atlas
 		void clear();
 		
@@ -82,17 +552,165 @@ class AtlasGenerator final {
 		 * Generates the actual atlas image. To increase performance, specify
 		 * `min_step` in order to increase the minimum step range for searching
 		 * a free location. Using min_step greater (1,1) will increase exection
-		 * speed but the result won't be perfect anymore.
+		 * speed but the result won't be perfect anymore. The `mode` selects
+		 * the packing strategy (see `PackingMode`); `min_step` is only used
+		 * by `PackingMode::Scan`, which is the reference implementation.
 		 * The `HashFunc` argument is unsed in order to arrange all frames
 		 * inside an `std::unordered_map`.
 		 * @throw std::length_error if an image is larger than the target
 		 * @param min_step determines the minimum step range for searching a free spot
 		 * @param size determines the target image's size per dimension.
 		 * @param [out] atlas which is generated
+		 * @param mode determines the packing strategy
 		 * @return true if success, false if not all images could be placed.
 		 */
 		template <typename HashFunc=std::hash<Key>>
-		bool generate(sf::Vector2u const & min_step, std::size_t size, Atlas<Key, HashFunc>& atlas);
+		bool generate(sf::Vector2u const & min_step, std::size_t size, Atlas<Key, HashFunc>& atlas, PackingMode mode=PackingMode::Scan);
+		
+		/// Generate the final image with a minimal size
+		/**
+		 * Works like `generate`, but a minimal size with power-of-two
+		 * dimensions up to `max_size` is determined automatically. Packing
+		 * starts at the smallest size which could hold all frames' area
+		 * and the largest frame. Whenever a frame does not fit, the bin's
+		 * smaller dimension is doubled (if possible) and packing
+		 * continues with that frame, so frames placed so far are kept
+		 * instead of packing again from scratch.
+		 * @throw std::runtime_error if an image is larger than `max_size`
+		 * @param min_step determines the minimum step range for searching a free spot
+		 * @param max_size determines the maximum image size per dimension
+		 * @param [out] atlas which is generated
+		 * @param mode determines the packing strategy
+		 * @return true if success, false if the frames exceed the maximum size
+		 */
+		template <typename HashFunc=std::hash<Key>>
+		bool generateMinimal(sf::Vector2u const & min_step, std::size_t max_size, Atlas<Key, HashFunc>& atlas,
+			PackingMode mode=PackingMode::MaxRects);
+		
+		/// Generate the final image with the best of multiple heuristics
+		/**
+		 * Works like `generateMinimal`, but packing is done once per
+		 * heuristic, i.e. combination of packing mode and sort order.
+		 * The heuristics are tried concurrently by a pool of worker
+		 * threads. The result with the smallest area (i.e. the best
+		 * occupancy) is kept. Ties are broken by the smaller maximum
+		 * dimension and then by the heuristic's position in the list, so
+		 * the result does not depend on the threads' timing. Frames with
+		 * equal sort keys are packed in their current order, i.e. the
+		 * order they were added in (unless another `generate` call
+		 * reordered them).
+		 * @throw std::runtime_error if an image is larger than `max_size`
+		 * @param min_step determines the minimum step range for searching a free spot
+		 * @param max_size determines the maximum image size per dimension
+		 * @param [out] atlas which is generated
+		 * @param heuristics to try, all non-scanning modes with all sort orders if empty
+		 * @param num_threads number of threads, 0 for all hardware threads
+		 * @param [out] best heuristic which produced the atlas (optional)
+		 * @return true if success, false if the frames exceed the maximum size
+		 */
+		template <typename HashFunc=std::hash<Key>>
+		bool generateBest(sf::Vector2u const & min_step, std::size_t max_size, Atlas<Key, HashFunc>& atlas,
+			std::vector<PackingHeuristic> heuristics={}, std::size_t num_threads=0u, PackingHeuristic* best=nullptr);
+		
+		/// Generate multiple atlas pages
+		/**
+		 * Works like `generate`, but frames which do not fit into a page
+		 * are placed on additional pages instead of failing. Each frame's
+		 * `page` refers to the page image holding it.
+		 * To reduce texture switches while rendering, frames can be
+		 * grouped (e.g. by a common key prefix): All frames with the same
+		 * group tag are placed on the same page if the group fits into a
+		 * page. Larger groups are spread across as few pages as possible.
+		 * @throw std::runtime_error if an image is larger than a page
+		 * @param min_step determines the minimum step range for searching a free spot
+		 * @param size determines each page's size per dimension
+		 * @param [out] atlas which is generated
+		 * @param mode determines the packing strategy
+		 * @param group returns a frame's group tag (all frames share one group if not set)
+		 */
+		template <typename HashFunc=std::hash<Key>>
+		void generatePages(sf::Vector2u const & min_step, std::size_t size, MultiAtlas<Key, HashFunc>& atlas,
+			PackingMode mode=PackingMode::MaxRects, std::function<std::string(Key const &)> group=nullptr);
+};
+
+// ---------------------------------------------------------------------------
+
+/// Image atlas which can be modified after creation
+/**
+ * Frames can be inserted and erased at runtime without packing all frames
+ * again. Free space is tracked as a list of free rectangles (see
+ * `MaxRectsPacker`). All modified pixels are accumulated in a dirty
+ * rectangle, so only that region needs to be uploaded to a texture.
+ * Erasing frames fragments the free space. `defragment` packs all frames
+ * again to compact the atlas.
+ */
+template <typename Key, typename HashFunc=std::hash<Key>>
+class IncrementalAtlas {
+	private:
+		Atlas<Key, HashFunc> atlas;
+		MaxRectsPacker packer;
+		sf::IntRect dirty;	// modified area since last `clearDirty`
+		bool fragmented;	// true if frames were erased since last rebuild
+		
+		/// Extend the dirty rectangle
+		void markDirty(sf::IntRect const & rect);
+		
+		/// Rebuild the maximal free rectangles from all frames
+		void rebuildFreeSpace();
+		
+		/// Place pixels of a shrinked image
+		bool place(Key const & key, sf::Image const & image, sf::IntRect const & bounds, sf::Vector2f const & origin);
+		
+	public:
+		/// Create an empty atlas
+		/**
+		 * @param size of the atlas image
+		 */
+		IncrementalAtlas(sf::Vector2u const & size);
+		
+		/// Insert a frame into free space
+		/**
+		 * The image is shrinked to its minimum size (see
+		 * `AtlasGenerator::add`). If a frame with that key already exists,
+		 * it is replaced and its area can be reused by the new frame. If
+		 * the new frame does not fit, the existing frame is kept unchanged.
+		 * @param key used to identify the image
+		 * @param image to copy into the atlas
+		 * @param origin for the original image
+		 * @return true if success, false if no free space was found
+		 */
+		bool insert(Key const & key, sf::Image const & image, sf::Vector2f origin);
+		
+		/// Erase a frame
+		/**
+		 * The frame's pixels are cleared and its area becomes free space.
+		 * @param key of the frame to erase
+		 * @return true if the frame existed
+		 */
+		bool erase(Key const & key);
+		
+		/// Pack all frames again to compact free space
+		/**
+		 * The entire atlas image is marked as dirty. If the frames do not
+		 * fit anymore, the atlas is kept unchanged.
+		 * @return true if success
+		 */
+		bool defragment();
+		
+		/// Get the rectangle which was modified since last `clearDirty`
+		/**
+		 * @return dirty rectangle (empty if nothing was modified)
+		 */
+		sf::IntRect getDirtyRect() const;
+		
+		/// Reset the dirty rectangle after uploading it
+		void clearDirty();
+		
+		/// Get the current atlas
+		/**
+		 * @return const reference to the atlas
+		 */
+		Atlas<Key, HashFunc> const & getAtlas() const;
 };
 
 } // ::sfext
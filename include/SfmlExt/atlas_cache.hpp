@@ -0,0 +1,214 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <SfmlExt/atlas.hpp>
+#include <SfmlExt/compression.hpp>
+#include <SfmlExt/frame_table.hpp>
+
+namespace sfext {
+
+/// Read-only memory mapping of an entire file
+class MappedFile {
+	private:
+		void const * data;
+		std::size_t size;
+#if defined(_WIN32)
+		void * file, * mapping;
+#endif
+		
+	public:
+		MappedFile();
+		~MappedFile();
+		
+		MappedFile(MappedFile const &) = delete;
+		MappedFile& operator=(MappedFile const &) = delete;
+		
+		/// Map a file into memory
+		/**
+		 * A previously mapped file is unmapped.
+		 * @param filename of the file to map
+		 * @return true if success
+		 */
+		bool open(std::string const & filename);
+		
+		/// Unmap the file
+		void close();
+		
+		/// Get pointer to the mapped bytes
+		/**
+		 * @return pointer to the first byte or nullptr if nothing is mapped
+		 */
+		void const * getData() const;
+		
+		/// Get number of mapped bytes
+		/**
+		 * @return size of the file
+		 */
+		std::size_t getSize() const;
+};
+
+/// Header of an atlas cache file
+struct AtlasCacheHeader {
+	char magic[8];				// "SFEXTATL"
+	std::uint32_t version;		// file format version
+	std::uint32_t entry_size;	// size of a frame table entry (depends on Key)
+	std::uint64_t input_hash;	// hash of all inputs and packing parameters
+	std::uint32_t width, height;	// size of the atlas image
+	BlockFormat format;			// format of the pixels
+	std::uint32_t reserved;		// zero
+	std::uint64_t frames_offset;	// byte offset of the frame table
+	std::uint64_t pixels_offset;	// byte offset of the pixels (RGBA or blocks)
+	std::uint64_t pixels_size;	// number of bytes of the pixels
+	std::uint64_t errors_offset;	// byte offset of the per-slot compression errors
+	std::uint64_t hulls_offset;	// byte offset of the hull vertices
+	std::uint64_t num_hull_vertices;	// number of hull vertices
+	FrameTableLayout table;		// layout of the frame table
+};
+
+/// Combine two hash values
+/**
+ * @param seed hash value to combine with
+ * @param value hash value to add
+ * @return combined hash value
+ */
+std::uint64_t hashCombine(std::uint64_t seed, std::uint64_t value);
+
+/// Calculate a hash of multiple files' contents
+/**
+ * Each file's name and content are hashed (see `hashBytes`), so the hash
+ * changes if any of the files' content is modified, but not if a file is
+ * only touched. The hash is stable across platforms and builds. Missing
+ * files are hashed by their name only.
+ * @param filenames to hash
+ * @return 64-bit hash value
+ */
+std::uint64_t hashFiles(std::vector<std::string> const & filenames);
+
+// ---------------------------------------------------------------------------
+
+/// Memory-mapped atlas cache file
+/**
+ * An atlas cache holds the raw RGBA pixels of an atlas image, its frame
+ * table and a hash of all inputs (e.g. `hashFiles` combined with the
+ * packing parameters using `hashCombine`). Loading a cache whose hash is
+ * up to date does neither decode any image nor pack any frame: The file is
+ * mapped into memory, the pixels can be uploaded directly from the mapping
+ * (e.g. using `sf::Texture::update`) and frames are looked up inside the
+ * mapping without any allocation.
+ * The pixels can optionally be block-compressed (see `compressImage`), so
+ * they can be uploaded to the GPU as compressed texture. In this case, the
+ * compression error of each frame is stored as well.
+ * The frame table is stored as `FrameTable`, so `Key` must be trivially
+ * copyable. If the table is hashed, `HashFunc` must yield the same values
+ * while saving and loading (e.g. `std::hash` of integral types).
+ */
+template <typename Key, typename HashFunc=std::hash<Key>>
+class AtlasCache {
+	private:
+		using Entry = FrameTableEntry<Key>;
+		
+		MappedFile file;
+		AtlasCacheHeader const * header;
+		FrameTable<Key, HashFunc> table; // attached to the mapping
+		
+	public:
+		/// Create an empty cache
+		AtlasCache();
+		
+		/// Open a cache file
+		/**
+		 * @param filename of the cache file
+		 * @param input_hash expected hash of all inputs
+		 * @return false if the file is missing, invalid or outdated
+		 */
+		bool open(std::string const & filename, std::uint64_t input_hash);
+		
+		/// Get the atlas image's size
+		/**
+		 * @return size of the atlas image
+		 */
+		sf::Vector2u getSize() const;
+		
+		/// Get the atlas image's pixels
+		/**
+		 * @return pointer to mapped RGBA pixels or nullptr if compressed
+		 */
+		sf::Uint8 const * getPixels() const;
+		
+		/// Get the format of the atlas image's pixels
+		/**
+		 * @return block format or `BlockFormat::None` if uncompressed
+		 */
+		BlockFormat getBlockFormat() const;
+		
+		/// Get the atlas image's compressed blocks
+		/**
+		 * The blocks are stored as described by `CompressedImage`.
+		 * @return pointer to mapped blocks or nullptr if uncompressed
+		 */
+		std::uint8_t const * getBlocks() const;
+		
+		/// Get number of frames
+		/**
+		 * @return number of frames
+		 */
+		std::size_t getNumFrames() const;
+		
+		/// Lookup a frame
+		/**
+		 * @param key of the frame
+		 * @return pointer to the mapped frame or nullptr if not found
+		 */
+		AtlasFrame const * find(Key const & key) const;
+		
+		/// Get a frame's compression error
+		/**
+		 * @param key of the frame
+		 * @return root mean square error per channel (see
+		 *	`getCompressionError`), 0 if uncompressed or negative if the
+		 *	frame was not found
+		 */
+		float getError(Key const & key) const;
+		
+		/// Get the frames' hull vertices
+		/**
+		 * @return pointer to mapped hull vertices (see `AtlasFrame`)
+		 */
+		sf::Vector2f const * getHulls() const;
+		
+		/// Get the mapped frame table
+		/**
+		 * @return frame table referring to the mapping
+		 */
+		FrameTable<Key, HashFunc> const & getFrameTable() const;
+		
+		/// Copy the cache into an atlas
+		/**
+		 * Compressed pixels are decompressed.
+		 * @param [out] atlas to copy to
+		 */
+		void copyTo(Atlas<Key, HashFunc>& atlas) const;
+};
+
+/// Save an atlas as cache file
+/**
+ * If a block format is given, the pixels are compressed and each frame's
+ * compression error is measured. Frames should then be aligned to blocks
+ * (see `AtlasGenerator::setBlockAlignment`), so no block is shared by
+ * multiple frames.
+ * @param filename of the cache file
+ * @param atlas to save
+ * @param input_hash hash of all inputs used to generate the atlas
+ * @param format to compress the pixels to
+ * @param num_threads number of threads used for compression, 0 for all hardware threads
+ * @return true if success
+ */
+template <typename Key, typename HashFunc>
+bool saveAtlasCache(std::string const & filename, Atlas<Key, HashFunc> const & atlas, std::uint64_t input_hash,
+	BlockFormat format=BlockFormat::None, std::size_t num_threads=0u);
+
+} // ::sfext
+
+// include implementation details
+#include <SfmlExt/details/atlas_cache.inl>
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Rect.hpp>
+
+namespace sfext {
+
+/// Supported pixel formats of compressed images
+enum class BlockFormat: std::uint32_t {
+	None,	// uncompressed RGBA8 pixels
+	BC1,	// 4x4 blocks of 8 bytes, 1-bit alpha (a.k.a. DXT1)
+	BC3,	// 4x4 blocks of 16 bytes, interpolated alpha (a.k.a. DXT5)
+	ETC2	// 4x4 blocks of 16 bytes, ETC2 RGBA8 with EAC alpha
+};
+
+/// Block-compressed image
+/**
+ * Blocks are stored row by row. Each block covers 4x4 pixels, so images
+ * whose size is not a multiple of 4 have partially used blocks at their
+ * right and bottom edge.
+ */
+struct CompressedImage {
+	BlockFormat format;
+	sf::Vector2u size;					// size of the image in pixels
+	std::vector<std::uint8_t> blocks;	// encoded blocks
+};
+
+/// Get number of bytes per block
+/**
+ * @param format to query
+ * @return bytes per 4x4 block (or per pixel if uncompressed)
+ */
+std::size_t getBlockSize(BlockFormat format);
+
+/// Compress an image into 4x4 blocks
+/**
+ * Rows of blocks are encoded concurrently by a pool of worker threads.
+ * If available, SSE is used to search the nearest palette entries.
+ * The ETC2 encoder only emits individual and differential mode blocks,
+ * which are valid ETC2 (and ETC1) color blocks.
+ * @param image to compress
+ * @param format to compress to (must not be `BlockFormat::None`)
+ * @param num_threads number of threads, 0 for all hardware threads
+ * @return compressed image
+ */
+CompressedImage compressImage(sf::Image const & image, BlockFormat format, std::size_t num_threads=0u);
+
+/// Decompress an image
+/**
+ * Only the block modes which are emitted by `compressImage` are
+ * supported, i.e. ETC2 blocks using T, H or planar mode are not decoded.
+ * @param image to decompress
+ * @param num_threads number of threads, 0 for all hardware threads
+ * @return uncompressed image
+ */
+sf::Image decompressImage(CompressedImage const & image, std::size_t num_threads=0u);
+
+/// Measure the compression error inside a rectangle
+/**
+ * The root mean square error of all channels is calculated. The color
+ * of fully transparent pixels is ignored.
+ * @param original image before compression
+ * @param decoded image after decompression
+ * @param rect to measure (must be inside both images)
+ * @return root mean square error per channel
+ */
+float getCompressionError(sf::Image const & original, sf::Image const & decoded, sf::IntRect const & rect);
+
+} // ::sfext
@@ -1,163 +1,926 @@
 #pragma once
+#include <condition_variable>
+#include <exception>
+#include <cstdint>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <algorithm>
 #include <stdexcept>
-#include <boost/math/common_factor_rt.hpp>
 #include <SFML/Graphics/Texture.hpp>
+#include <SfmlExt/parallel.hpp>
 
 namespace sfext {
 
 template <typename Key>
-Chunk<Key>::Chunk(Key const & key, sf::Image&& img, sf::IntRect const & bounds, sf::Vector2f const & origin)
+Chunk<Key>::Chunk(Key const & key, sf::Image&& img, sf::Vector2f const & origin)
 	: key{key}
-	, image{img}
-	, bounds{bounds}
-	, target{0, 0, bounds.width, bounds.height}
-	, origin{origin} {
+	, image{std::move(img)}
+	, bounds{{0, 0}, sf::Vector2i{image.getSize()}}
+	, target{bounds}
+	, rotated{false}
+	, origin{origin}
+	, hash{0u}
+	, aliases{} {
 }
 
 // ---------------------------------------------------------------------------
 
 template <typename Key>
-bool AtlasGenerator<Key>::rowIsEmpty(sf::Image const & image, std::size_t row) {
-	auto size = image.getSize();
-	for (std::size_t x = 0u; x < size.x; ++x) {
-		if (image.getPixel(x, row).a > 0) {
-			return false;
-		}
+AtlasGenerator<Key>::AtlasGenerator()
+	: chunks{}
+	, deduplicate{false}
+	, rotate{false}
+	, max_hull_vertices{0u}
+	, align_blocks{false}
+	, gutter{0u}
+	, tolerance{0u}
+	, lookup{}
+	, memory{0u}
+	, peak_memory{0u} {
+}
+
+template <typename Key>
+std::uint64_t AtlasGenerator<Key>::getBucket(Chunk<Key> const & chunk) const {
+	if (tolerance > 0u) {
+		// nearly identical images only share their size
+		return (static_cast<std::uint64_t>(chunk.bounds.width) << 32u) | static_cast<std::uint32_t>(chunk.bounds.height);
 	}
-	return true;
+	return chunk.hash;
 }
 
 template <typename Key>
-bool AtlasGenerator<Key>::colIsEmpty(sf::Image const & image, std::size_t col) {
-	auto size = image.getSize();
-	for (std::size_t y = 0u; y < size.y; ++y) {
-		if (image.getPixel(col, y).a > 0) {
-			return false;
+void AtlasGenerator<Key>::rebuildLookup() {
+	lookup.clear();
+	if (!deduplicate) {
+		return;
+	}
+	for (std::size_t i = 0u; i < chunks.size(); ++i) {
+		lookup.emplace(getBucket(chunks[i]), i);
+	}
+}
+
+template <typename Key>
+void AtlasGenerator<Key>::shrinkImage(sf::Image& image, sf::IntRect const & bounds) {
+	if (bounds.left != 0 || bounds.top != 0 || sf::Vector2u(bounds.width, bounds.height) != image.getSize()) {
+		image = cropImage(image, bounds);
+	}
+}
+
+template <typename Key>
+void AtlasGenerator<Key>::addChunk(Key const & key, sf::Image&& image, sf::Vector2f const & origin, std::uint64_t hash) {
+	Chunk<Key> chunk{key, std::move(image), origin};
+	chunk.hash = hash;
+	if (deduplicate) {
+		// search duplicate
+		auto range = lookup.equal_range(getBucket(chunk));
+		for (auto i = range.first; i != range.second; ++i) {
+			auto& other = chunks[i->second];
+			if (other.bounds.width == chunk.bounds.width && other.bounds.height == chunk.bounds.height
+				&& comparePixels(other.image, other.bounds, chunk.image, chunk.bounds, tolerance)) {
+				other.aliases.emplace_back(key, origin);
+				memory += sizeof(std::pair<Key, sf::Vector2f>);
+				trackPeak(0u);
+				return;
+			}
 		}
+		lookup.emplace(getBucket(chunk), chunks.size());
 	}
-	return true;
+	memory += sizeof(Chunk<Key>) + 4u * chunk.bounds.width * chunk.bounds.height;
+	chunks.push_back(std::move(chunk));
+	trackPeak(0u);
+}
+
+template <typename Key>
+void AtlasGenerator<Key>::trackPeak(std::size_t extra) {
+	peak_memory = std::max(peak_memory, memory + extra);
+}
+
+template <typename Key>
+void AtlasGenerator<Key>::setDeduplication(bool enabled, sf::Uint8 tolerance) {
+	deduplicate = enabled;
+	this->tolerance = tolerance;
+	rebuildLookup();
+}
+
+template <typename Key>
+void AtlasGenerator<Key>::setRotation(bool enabled) {
+	rotate = enabled;
+}
+
+template <typename Key>
+AtlasMemoryUsage AtlasGenerator<Key>::getMemoryUsage() const {
+	AtlasMemoryUsage usage;
+	usage.num_chunks = chunks.size();
+	usage.current = memory;
+	usage.peak = peak_memory;
+	return usage;
+}
+
+template <typename Key>
+void AtlasGenerator<Key>::setHulls(std::size_t max_vertices) {
+	max_hull_vertices = (max_vertices > 0u) ? std::max<std::size_t>(max_vertices, 3u) : 0u;
+}
+
+template <typename Key>
+void AtlasGenerator<Key>::setBlockAlignment(bool enabled) {
+	align_blocks = enabled;
+}
+
+template <typename Key>
+void AtlasGenerator<Key>::setGutter(unsigned int width) {
+	gutter = width;
+}
+
+template <typename Key>
+std::size_t AtlasGenerator<Key>::getNumDuplicates() const {
+	std::size_t num{0u};
+	for (auto const & chunk: chunks) {
+		num += chunk.aliases.size();
+	}
+	return num;
 }
 
 template <typename Key>
 void AtlasGenerator<Key>::add(Key const & key, sf::Image&& image, sf::Vector2f origin) {
-	auto size = sf::Vector2i{image.getSize()};
-	sf::IntRect bounds{{0u, 0u}, size};
+	// shrink to non-transparent pixels
+	auto bounds = getOpaqueBounds(image);
+	origin.x -= bounds.left;
+	origin.y -= bounds.top;
 	
-	// shrink from bottom
-	while (rowIsEmpty(image, bounds.height - 2u)) {
-		--bounds.height;
+	// create chunk
+	auto hash = deduplicate ? hashPixels(image, bounds) : 0u;
+	shrinkImage(image, bounds);
+	addChunk(key, std::move(image), origin, hash);
+}
+
+template <typename Key>
+template <typename Iter>
+void AtlasGenerator<Key>::addRange(Iter begin, Iter end, std::size_t num_threads) {
+	std::vector<AtlasInput<Key>*> inputs;
+	for (auto i = begin; i != end; ++i) {
+		inputs.push_back(&*i);
 	}
-	// shrink from right
-	while (colIsEmpty(image, bounds.width - 2u)) {
-		--bounds.width;
+	
+	// shrink images in parallel
+	std::vector<sf::IntRect> bounds(inputs.size());
+	std::vector<std::uint64_t> hashes(inputs.size(), 0u);
+	parallelFor(inputs.size(), num_threads, [&](std::size_t i) {
+		bounds[i] = getOpaqueBounds(inputs[i]->image);
+		if (deduplicate) {
+			hashes[i] = hashPixels(inputs[i]->image, bounds[i]);
+		}
+		shrinkImage(inputs[i]->image, bounds[i]);
+	});
+	
+	// create chunks in input order
+	chunks.reserve(chunks.size() + inputs.size());
+	for (std::size_t i = 0u; i < inputs.size(); ++i) {
+		auto& input = *inputs[i];
+		auto origin = input.origin;
+		origin.x -= bounds[i].left;
+		origin.y -= bounds[i].top;
+		addChunk(input.key, std::move(input.image), origin, hashes[i]);
 	}
-	// shrink from top
-	while (rowIsEmpty(image, bounds.top + 1u)) {
-		++bounds.top;
-		--bounds.height;
-		--origin.y;
+}
+
+template <typename Key>
+void AtlasGenerator<Key>::addBatch(std::vector<AtlasInput<Key>>&& inputs, std::size_t num_threads) {
+	addRange(inputs.begin(), inputs.end(), num_threads);
+}
+
+template <typename Key>
+std::vector<std::string> AtlasGenerator<Key>::load(std::vector<AtlasFile<Key>> const & files,
+	std::size_t max_in_flight, std::size_t num_threads) {
+	/// Shrinked image passed from the workers to the calling thread
+	struct Slot {
+		bool done{false}, loaded{false};
+		sf::Image image;
+		sf::IntRect bounds;
+		std::uint64_t hash{0u};
+	};
+	std::vector<Slot> slots(files.size());
+	std::mutex mutex;
+	std::condition_variable ready, capacity;
+	std::size_t in_flight{0u};
+	bool cancelled{false};				// set if the calling thread stops consuming
+	std::exception_ptr error{nullptr};	// thrown by the decoder thread
+	max_in_flight = std::max<std::size_t>(max_in_flight, 1u);
+	
+	// decode and shrink images in the background
+	std::thread decoder{[&]() {
+		try {
+			parallelFor(files.size(), num_threads, [&](std::size_t i) {
+				{
+					std::unique_lock<std::mutex> lock{mutex};
+					capacity.wait(lock, [&]() { return cancelled || in_flight < max_in_flight; });
+					if (cancelled) {
+						return;
+					}
+					++in_flight;
+				}
+				sf::Image cropped;
+				sf::IntRect bounds;
+				std::uint64_t hash{0u};
+				bool loaded{false};
+				try {
+					sf::Image image;
+					loaded = image.loadFromFile(files[i].filename);
+					if (loaded) {
+						bounds = getOpaqueBounds(image);
+						cropped = cropImage(image, bounds);
+						if (deduplicate) {
+							hash = hashPixels(image, bounds);
+						}
+					}
+				} catch (...) {
+					loaded = false;
+				}
+				{
+					std::lock_guard<std::mutex> lock{mutex};
+					--in_flight;
+					auto& slot = slots[i];
+					slot.done = true;
+					slot.loaded = loaded;
+					slot.image = std::move(cropped);
+					slot.bounds = bounds;
+					slot.hash = hash;
+				}
+				capacity.notify_one();
+				ready.notify_all();
+			});
+		} catch (...) {
+			// note: exceptions must not escape the thread, they are rethrown by the calling thread
+			std::lock_guard<std::mutex> lock{mutex};
+			error = std::current_exception();
+		}
+		ready.notify_all();
+	}};
+	
+	// create chunks in file order as soon as they are available
+	std::vector<std::string> failed;
+	try {
+		chunks.reserve(chunks.size() + files.size());
+		for (std::size_t i = 0u; i < files.size(); ++i) {
+			Slot slot;
+			{
+				std::unique_lock<std::mutex> lock{mutex};
+				ready.wait(lock, [&]() { return slots[i].done || error != nullptr; });
+				if (!slots[i].done) {
+					// decoder failed
+					break;
+				}
+				slot = std::move(slots[i]);
+			}
+			if (!slot.loaded) {
+				failed.push_back(files[i].filename);
+				continue;
+			}
+			auto origin = files[i].origin;
+			origin.x -= slot.bounds.left;
+			origin.y -= slot.bounds.top;
+			addChunk(files[i].key, std::move(slot.image), origin, slot.hash);
+		}
+	} catch (...) {
+		// stop the workers before the thread is destroyed
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			cancelled = true;
+		}
+		capacity.notify_all();
+		decoder.join();
+		throw;
 	}
-	// shrink from left
-	while (colIsEmpty(image, bounds.left + 1u)) {
-		++bounds.left;
-		--bounds.width;
-		--origin.x;
+	decoder.join();
+	if (error != nullptr) {
+		std::rethrow_exception(error);
 	}
 	
-	// create chunk
-	chunks.emplace_back(key, std::move(image), bounds, origin);
+	return failed;
 }
 
 template <typename Key>
 void AtlasGenerator<Key>::clear() {
 	chunks.clear();
+	lookup.clear();
+	memory = 0u;
 }
 
 template <typename Key>
-template <typename HashFunc>
-bool AtlasGenerator<Key>::generate(sf::Vector2u const & min_step, std::size_t size, Atlas<Key, HashFunc>& atlas) {
-	// sort chunks by size (descending)
+void AtlasGenerator<Key>::sortChunks() {
 	std::sort(chunks.begin(), chunks.end(),
 		[](Chunk<Key> const & left, Chunk<Key> const & right) {
 		auto a = left.bounds.width * left.bounds.height;
 		auto b = right.bounds.width * right.bounds.height;
 		return a > b;
 	});
+	rebuildLookup();
+}
+
+template <typename Key>
+std::unique_ptr<RectPacker> AtlasGenerator<Key>::createChunkPacker(PackingMode mode, sf::Vector2u const & min_step) const {
+	if (!align_blocks) {
+		return createPacker(mode, min_step);
+	}
+	return createPacker(mode, {(std::max(min_step.x, 1u) + 3u) / 4u * 4u, (std::max(min_step.y, 1u) + 3u) / 4u * 4u});
+}
+
+template <typename Key>
+bool AtlasGenerator<Key>::placeChunk(RectPacker& packer, Chunk<Key> const & chunk, Placement& placement) const {
+	sf::Vector2i pos;
+	auto border = static_cast<int>(align_blocks ? (gutter + 3u) / 4u * 4u : gutter);
+	sf::Vector2i size{chunk.bounds.width + 2 * border, chunk.bounds.height + 2 * border};
+	if (align_blocks) {
+		size.x = (size.x + 3) / 4 * 4;
+		size.y = (size.y + 3) / 4 * 4;
+	}
+	bool rotated{false};
+	if (!packer.insert(size, pos, rotate ? &rotated : nullptr)) {
+		return false;
+	}
+	placement.rotated = rotated;
+	placement.target = {pos.x + border, pos.y + border, chunk.bounds.width, chunk.bounds.height};
+	if (rotated) {
+		std::swap(placement.target.width, placement.target.height);
+	}
+	return true;
+}
+
+template <typename Key>
+bool AtlasGenerator<Key>::insertChunk(RectPacker& packer, Chunk<Key>& chunk) const {
+	Placement placement;
+	if (!placeChunk(packer, chunk, placement)) {
+		return false;
+	}
+	chunk.target = placement.target;
+	chunk.rotated = placement.rotated;
+	return true;
+}
+
+template <typename Key>
+std::vector<std::size_t> AtlasGenerator<Key>::getOrder(SortOrder order) const {
+	auto key = [order](Chunk<Key> const & chunk) {
+		auto w = chunk.bounds.width, h = chunk.bounds.height;
+		switch (order) {
+			case SortOrder::Area: return w * h;
+			case SortOrder::MaxSide: return std::max(w, h);
+			case SortOrder::Perimeter: return w + h;
+			case SortOrder::Width: return w;
+			case SortOrder::Height: return h;
+		}
+		return 0;
+	};
+	std::vector<std::size_t> indices(chunks.size());
+	for (std::size_t i = 0u; i < indices.size(); ++i) {
+		indices[i] = i;
+	}
+	// note: stable sorting keeps the order deterministic
+	std::stable_sort(indices.begin(), indices.end(), [&](std::size_t left, std::size_t right) {
+		return key(chunks[left]) > key(chunks[right]);
+	});
+	return indices;
+}
+
+template <typename Key>
+bool AtlasGenerator<Key>::packMinimal(std::vector<std::size_t> const & order, PackingMode mode,
+	sf::Vector2u const & min_step, std::size_t max_size, sf::Vector2u& size, std::vector<Placement>& placements) const {
+	// determine lower bound by area and largest dimensions
+	std::size_t area{0u};
+	size = {1u, 1u};
+	for (auto const & chunk: chunks) {
+		if (static_cast<std::size_t>(chunk.bounds.width) > max_size || static_cast<std::size_t>(chunk.bounds.height) > max_size) {
+			throw std::runtime_error("Too small target size");
+		}
+		area += chunk.bounds.width * chunk.bounds.height;
+		while (size.x < static_cast<unsigned int>(chunk.bounds.width)) {
+			size.x *= 2u;
+		}
+		while (size.y < static_cast<unsigned int>(chunk.bounds.height)) {
+			size.y *= 2u;
+		}
+	}
+	if (size.x > max_size || size.y > max_size) {
+		// next power of two of a chunk's dimension exceeds the maximum size
+		return false;
+	}
+	// enlarge smaller dimension first (width on ties)
+	auto enlarge = [&]() {
+		auto& dim = (size.x <= size.y) ? size.x : size.y;
+		if (dim * 2u <= max_size) {
+			dim *= 2u;
+			return true;
+		}
+		auto& other = (size.x <= size.y) ? size.y : size.x;
+		if (other * 2u <= max_size) {
+			other *= 2u;
+			return true;
+		}
+		return false;
+	};
+	while (static_cast<std::size_t>(size.x) * size.y < area) {
+		if (!enlarge()) {
+			return false;
+		}
+	}
+	
+	// place chunks, enlarge bin if necessary
+	placements.assign(chunks.size(), Placement{{}, false});
+	auto packer = createChunkPacker(mode, min_step);
+	packer->reset(size);
+	for (auto index: order) {
+		auto const & chunk = chunks[index];
+		if (chunk.bounds.width == 0 || chunk.bounds.height == 0) {
+			// empty frame: nothing to place
+			continue;
+		}
+		while (!placeChunk(*packer, chunk, placements[index])) {
+			if (!enlarge()) {
+				// no space found
+				return false;
+			}
+			packer->grow(size);
+		}
+	}
+	return true;
+}
+
+template <typename Key>
+void AtlasGenerator<Key>::blitChunks(std::vector<sf::Image*> const & pages, std::vector<std::size_t> const & page_of) const {
+	parallelFor(chunks.size(), 0u, [&](std::size_t i) {
+		auto const & chunk = chunks[i];
+		if (chunk.bounds.width == 0 || chunk.bounds.height == 0) {
+			return;
+		}
+		auto& image = *pages[page_of.empty() ? 0u : page_of[i]];
+		blitImage(image, {chunk.target.left, chunk.target.top}, chunk.image, chunk.bounds, chunk.rotated);
+		if (gutter > 0u) {
+			extrudeEdges(image, chunk.target, align_blocks ? (gutter + 3u) / 4u * 4u : gutter);
+		}
+	});
+}
+
+template <typename Key>
+void AtlasGenerator<Key>::createHulls(std::vector<sf::Vector2f>& hulls,
+	std::vector<std::pair<std::uint32_t, std::uint32_t>>& ranges) const {
+	hulls.clear();
+	ranges.assign(chunks.size(), {0u, 0u});
+	if (max_hull_vertices == 0u) {
+		return;
+	}
+	std::vector<std::vector<sf::Vector2f>> tmp(chunks.size());
+	parallelFor(chunks.size(), 0u, [&](std::size_t i) {
+		tmp[i] = getConvexHull(chunks[i].image, chunks[i].bounds, max_hull_vertices);
+	});
+	for (std::size_t i = 0u; i < chunks.size(); ++i) {
+		ranges[i] = {static_cast<std::uint32_t>(hulls.size()), static_cast<std::uint32_t>(tmp[i].size())};
+		hulls.insert(hulls.end(), tmp[i].begin(), tmp[i].end());
+	}
+}
+
+template <typename Key>
+template <typename HashFunc>
+void AtlasGenerator<Key>::storeFrames(Chunk<Key> const & chunk, AtlasFrame frame, std::unordered_map<Key, AtlasFrame, HashFunc>& frames) const {
+	frame.origin = chunk.origin;
+	frames[chunk.key] = frame;
+	// duplicates share the clipping but keep their origin
+	for (auto const & alias: chunk.aliases) {
+		frame.origin = alias.second;
+		frames[alias.first] = frame;
+	}
+}
+
+template <typename Key>
+template <typename HashFunc>
+void AtlasGenerator<Key>::createAtlas(sf::Vector2u const & size, Atlas<Key, HashFunc>& atlas) const {
+	atlas.image.create(size.x, size.y, sf::Color::Transparent);
+	blitChunks({&atlas.image}, {});
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> ranges;
+	createHulls(atlas.hulls, ranges);
+	atlas.frames.clear();
+	for (std::size_t i = 0u; i < chunks.size(); ++i) {
+		auto const & chunk = chunks[i];
+		AtlasFrame frame;
+		frame.clipping = chunk.target;
+		frame.page = 0u;
+		frame.rotated = chunk.rotated;
+		frame.hull_offset = ranges[i].first;
+		frame.hull_size = ranges[i].second;
+		storeFrames(chunk, frame, atlas.frames);
+	}
+}
+
+template <typename Key>
+template <typename HashFunc>
+bool AtlasGenerator<Key>::generate(sf::Vector2u const & min_step, std::size_t size, Atlas<Key, HashFunc>& atlas, PackingMode mode) {
+	// sort chunks by size (descending)
+	sortChunks();
 
 	// place chunks
-	std::unordered_map<Key, Chunk<Key> const *, HashFunc> lookup;
-	sf::Vector2i step_range{min_step};
+	auto packer = createChunkPacker(mode, min_step);
+	packer->reset({static_cast<unsigned int>(size), static_cast<unsigned int>(size)});
 	for (auto& chunk: chunks) {
-		if (chunk.bounds.width > size || chunk.bounds.height > size) {
+		if (static_cast<std::size_t>(chunk.bounds.width) > size || static_cast<std::size_t>(chunk.bounds.height) > size) {
 			throw std::runtime_error("Too small target size");
 		}
 		
-		if (lookup.empty()) {
-			// free space found
-			step_range.x = chunk.bounds.width;
-			step_range.y = chunk.bounds.height;
-			// placed at (0,0)
-			lookup[chunk.key] = &chunk;			
+		if (chunk.bounds.width == 0 || chunk.bounds.height == 0) {
+			// empty frame: nothing to place
+			chunk.target = {};
 			continue;
 		}
+		if (!insertChunk(*packer, chunk)) {
+			// no space found
+			return false;
+		}
+	}
+	
+	// create actual atlas
+	trackPeak(4u * size * size);
+	createAtlas({static_cast<unsigned int>(size), static_cast<unsigned int>(size)}, atlas);
+	
+	return true;
+}
 
-		// search for space
-		auto max_left	= size - chunk.bounds.width;
-		auto max_top	= size - chunk.bounds.height;
-		bool added{false}; // true = chunk was added to atlas
-		for (chunk.target.top = 0u; chunk.target.top <= max_top; chunk.target.top += step_range.y) {
-			for (chunk.target.left = 0u; chunk.target.left <= max_left; chunk.target.left += step_range.x) {
-				bool found{true}; // true = space was found
-				// compare with already placed chunks
-				for (auto const & pair: lookup) {
-					if (chunk.target.intersects(pair.second->target)) {
-						// collision with another chunk, skip this position
-						found = false;
-						break;
-					}
-				}
+template <typename Key>
+template <typename HashFunc>
+bool AtlasGenerator<Key>::generateMinimal(sf::Vector2u const & min_step, std::size_t max_size, Atlas<Key, HashFunc>& atlas,
+	PackingMode mode) {
+	// sort chunks by size (descending)
+	sortChunks();
+	
+	// place chunks
+	std::vector<std::size_t> order(chunks.size());
+	for (std::size_t i = 0u; i < order.size(); ++i) {
+		order[i] = i;
+	}
+	sf::Vector2u size;
+	std::vector<Placement> placements;
+	if (!packMinimal(order, mode, min_step, max_size, size, placements)) {
+		return false;
+	}
+	for (std::size_t i = 0u; i < chunks.size(); ++i) {
+		chunks[i].target = placements[i].target;
+		chunks[i].rotated = placements[i].rotated;
+	}
+	
+	// create actual atlas
+	trackPeak(4u * static_cast<std::size_t>(size.x) * size.y);
+	createAtlas(size, atlas);
+	
+	return true;
+}
 
-				if (found) {
-					// recalc step range using gcd per dimension
-					step_range.x = boost::math::gcd(step_range.x, chunk.bounds.width);
-					step_range.y = boost::math::gcd(step_range.y, chunk.bounds.height);
-					
-					// note: this might speedup generation, but the result won't be perfect anymore
-					step_range.x = std::max(step_range.x, static_cast<int>(min_step.x));
-					step_range.y = std::max(step_range.y, static_cast<int>(min_step.y));
-					
-					// placed at current (top,left)
-					added = true;
-					lookup[chunk.key] = &chunk;
-					break;
-				}
-			}
-			if (added) {
-				break;
+template <typename Key>
+template <typename HashFunc>
+bool AtlasGenerator<Key>::generateBest(sf::Vector2u const & min_step, std::size_t max_size, Atlas<Key, HashFunc>& atlas,
+	std::vector<PackingHeuristic> heuristics, std::size_t num_threads, PackingHeuristic* best) {
+	if (heuristics.empty()) {
+		// all fast packers with all sort orders
+		for (auto mode: {PackingMode::MaxRects, PackingMode::Skyline, PackingMode::Guillotine}) {
+			for (auto order: {SortOrder::Area, SortOrder::MaxSide, SortOrder::Perimeter, SortOrder::Width, SortOrder::Height}) {
+				heuristics.push_back({mode, order});
 			}
 		}
-		if (added) {
+	}
+	// note: chunks are not reordered here, each heuristic sorts indices
+	// stably (see `getOrder`), so the result is deterministic
+	
+	// try all heuristics concurrently
+	struct Result {
+		bool success;
+		sf::Vector2u size;
+		std::vector<Placement> placements;
+	};
+	std::vector<Result> results(heuristics.size());
+	parallelFor(heuristics.size(), num_threads, [&](std::size_t i) {
+		auto& result = results[i];
+		result.success = packMinimal(getOrder(heuristics[i].order), heuristics[i].mode, min_step, max_size,
+			result.size, result.placements);
+	});
+	
+	// pick smallest area, then squarest size, then first heuristic
+	auto index = results.size();
+	for (std::size_t i = 0u; i < results.size(); ++i) {
+		if (!results[i].success) {
 			continue;
 		}
-		
-		// no space found
+		if (index == results.size()) {
+			index = i;
+			continue;
+		}
+		auto const & lhs = results[i].size;
+		auto const & rhs = results[index].size;
+		auto lhs_area = static_cast<std::size_t>(lhs.x) * lhs.y;
+		auto rhs_area = static_cast<std::size_t>(rhs.x) * rhs.y;
+		if (lhs_area < rhs_area || (lhs_area == rhs_area && std::max(lhs.x, lhs.y) < std::max(rhs.x, rhs.y))) {
+			index = i;
+		}
+	}
+	if (index == results.size()) {
 		return false;
 	}
+	auto const & result = results[index];
+	for (std::size_t i = 0u; i < chunks.size(); ++i) {
+		chunks[i].target = result.placements[i].target;
+		chunks[i].rotated = result.placements[i].rotated;
+	}
+	if (best != nullptr) {
+		*best = heuristics[index];
+	}
 	
 	// create actual atlas
-	atlas.image.create(size, size, sf::Color::Transparent);
+	trackPeak(4u * static_cast<std::size_t>(result.size.x) * result.size.y);
+	createAtlas(result.size, atlas);
+	
+	return true;
+}
+
+template <typename Key>
+template <typename HashFunc>
+void AtlasGenerator<Key>::generatePages(sf::Vector2u const & min_step, std::size_t size, MultiAtlas<Key, HashFunc>& atlas,
+	PackingMode mode, std::function<std::string(Key const &)> group) {
+	// sort chunks by size (descending)
+	sortChunks();
+	
+	// collect groups in order of their largest chunk
+	std::vector<std::vector<Chunk<Key>*>> groups;
+	std::unordered_map<std::string, std::size_t> group_index;
+	for (auto& chunk: chunks) {
+		if (static_cast<std::size_t>(chunk.bounds.width) > size || static_cast<std::size_t>(chunk.bounds.height) > size) {
+			throw std::runtime_error("Too small target size");
+		}
+		if (chunk.bounds.width == 0 || chunk.bounds.height == 0) {
+			// empty frame: nothing to place
+			chunk.target = {};
+			continue;
+		}
+		auto tag = (group != nullptr) ? group(chunk.key) : std::string{};
+		auto i = group_index.find(tag);
+		if (i == group_index.end()) {
+			i = group_index.emplace(tag, groups.size()).first;
+			groups.emplace_back();
+		}
+		groups[i->second].push_back(&chunk);
+	}
+	
+	// place chunks
+	std::vector<std::unique_ptr<RectPacker>> pages;
+	std::vector<std::size_t> page_of(chunks.size(), 0u);
+	auto index_of = [&](Chunk<Key> const * chunk) {
+		return static_cast<std::size_t>(chunk - chunks.data());
+	};
+	auto new_page = [&]() {
+		pages.push_back(createChunkPacker(mode, min_step));
+		pages.back()->reset({static_cast<unsigned int>(size), static_cast<unsigned int>(size)});
+	};
+	// try to place an entire group on a copy of the page's packer
+	auto place_group = [&](std::vector<Chunk<Key>*> const & members, std::size_t page) {
+		// note: targets of a rejected group are overwritten by the next attempt
+		auto packer = pages[page]->clone();
+		for (auto chunk: members) {
+			if (!insertChunk(*packer, *chunk)) {
+				return false;
+			}
+		}
+		for (auto chunk: members) {
+			page_of[index_of(chunk)] = page;
+		}
+		pages[page] = std::move(packer);
+		return true;
+	};
+	for (auto const & members: groups) {
+		bool placed{false};
+		for (std::size_t page = 0u; page < pages.size() && !placed; ++page) {
+			placed = place_group(members, page);
+		}
+		if (!placed) {
+			new_page();
+			placed = place_group(members, pages.size() - 1u);
+		}
+		if (placed) {
+			continue;
+		}
+		// group exceeds a page: prefer the most recent page to keep it together
+		for (auto chunk: members) {
+			auto page = pages.size();
+			while (page > 0u && !insertChunk(*pages[page - 1u], *chunk)) {
+				--page;
+			}
+			if (page == 0u) {
+				new_page();
+				page = pages.size();
+				insertChunk(*pages.back(), *chunk);
+			}
+			page_of[index_of(chunk)] = page - 1u;
+		}
+	}
+	
+	// create actual pages
+	atlas.pages.clear();
+	atlas.pages.resize(std::max<std::size_t>(pages.size(), 1u));
+	trackPeak(4u * size * size * atlas.pages.size());
+	for (auto& image: atlas.pages) {
+		image.create(size, size, sf::Color::Transparent);
+	}
+	std::vector<sf::Image*> images;
+	for (auto& image: atlas.pages) {
+		images.push_back(&image);
+	}
+	blitChunks(images, page_of);
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> ranges;
+	createHulls(atlas.hulls, ranges);
 	atlas.frames.clear();
-	for (auto const & chunk: chunks) {
-		atlas.image.copy(chunk.image, chunk.target.left, chunk.target.top, chunk.bounds);
+	for (std::size_t i = 0u; i < chunks.size(); ++i) {
+		auto const & chunk = chunks[i];
 		AtlasFrame frame;
 		frame.clipping = chunk.target;
-		frame.origin = chunk.origin;
-		atlas.frames[chunk.key] = std::move(frame);
+		frame.page = page_of[i];
+		frame.rotated = chunk.rotated;
+		frame.hull_offset = ranges[i].first;
+		frame.hull_size = ranges[i].second;
+		storeFrames(chunk, frame, atlas.frames);
+	}
+}
+
+// ---------------------------------------------------------------------------
+
+template <typename Key, typename HashFunc>
+IncrementalAtlas<Key, HashFunc>::IncrementalAtlas(sf::Vector2u const & size)
+	: atlas{}
+	, packer{}
+	, dirty{}
+	, fragmented{false} {
+	atlas.image.create(size.x, size.y, sf::Color::Transparent);
+	packer.reset(size);
+}
+
+template <typename Key, typename HashFunc>
+void IncrementalAtlas<Key, HashFunc>::markDirty(sf::IntRect const & rect) {
+	if (rect.width == 0 || rect.height == 0) {
+		return;
+	}
+	if (dirty.width == 0 || dirty.height == 0) {
+		dirty = rect;
+		return;
+	}
+	auto right = std::max(dirty.left + dirty.width, rect.left + rect.width);
+	auto bottom = std::max(dirty.top + dirty.height, rect.top + rect.height);
+	dirty.left = std::min(dirty.left, rect.left);
+	dirty.top = std::min(dirty.top, rect.top);
+	dirty.width = right - dirty.left;
+	dirty.height = bottom - dirty.top;
+}
+
+template <typename Key, typename HashFunc>
+void IncrementalAtlas<Key, HashFunc>::rebuildFreeSpace() {
+	packer.reset(atlas.image.getSize());
+	for (auto const & pair: atlas.frames) {
+		auto const & clipping = pair.second.clipping;
+		if (clipping.width > 0 && clipping.height > 0) {
+			packer.occupy(clipping);
+		}
+	}
+	fragmented = false;
+}
+
+template <typename Key, typename HashFunc>
+bool IncrementalAtlas<Key, HashFunc>::place(Key const & key, sf::Image const & image, sf::IntRect const & bounds,
+	sf::Vector2f const & origin) {
+	AtlasFrame frame;
+	frame.clipping = {0, 0, bounds.width, bounds.height};
+	frame.origin = origin;
+	frame.page = 0u;
+	frame.rotated = false;
+	frame.hull_offset = 0u;
+	frame.hull_size = 0u;
+	if (bounds.width > 0 && bounds.height > 0) {
+		sf::Vector2i pos;
+		if (!packer.insert({bounds.width, bounds.height}, pos)) {
+			if (!fragmented) {
+				return false;
+			}
+			// retry with maximal free rectangles
+			rebuildFreeSpace();
+			if (!packer.insert({bounds.width, bounds.height}, pos)) {
+				return false;
+			}
+		}
+		frame.clipping.left = pos.x;
+		frame.clipping.top = pos.y;
+		blitImage(atlas.image, pos, image, bounds);
+		markDirty(frame.clipping);
+	}
+	atlas.frames[key] = frame;
+	return true;
+}
+
+template <typename Key, typename HashFunc>
+bool IncrementalAtlas<Key, HashFunc>::insert(Key const & key, sf::Image const & image, sf::Vector2f origin) {
+	// shrink to non-transparent pixels
+	auto bounds = getOpaqueBounds(image);
+	origin.x -= bounds.left;
+	origin.y -= bounds.top;
+	
+	auto i = atlas.frames.find(key);
+	if (i == atlas.frames.end()) {
+		return place(key, image, bounds, origin);
+	}
+	
+	// release the old frame tentatively, so the new one can reuse its area
+	auto frame = i->second;
+	auto pixels = cropImage(atlas.image, frame.clipping);
+	auto previous_packer = packer;
+	auto previous_dirty = dirty;
+	auto previous_fragmented = fragmented;
+	erase(key);
+	if (place(key, image, bounds, origin)) {
+		return true;
+	}
+	
+	// restore the old frame
+	if (frame.clipping.width > 0 && frame.clipping.height > 0) {
+		atlas.image.copy(pixels, frame.clipping.left, frame.clipping.top);
+	}
+	atlas.frames[key] = frame;
+	packer = std::move(previous_packer);
+	dirty = previous_dirty;
+	fragmented = previous_fragmented;
+	return false;
+}
+
+template <typename Key, typename HashFunc>
+bool IncrementalAtlas<Key, HashFunc>::erase(Key const & key) {
+	auto i = atlas.frames.find(key);
+	if (i == atlas.frames.end()) {
+		return false;
+	}
+	auto clipping = i->second.clipping;
+	atlas.frames.erase(i);
+	if (clipping.width > 0 && clipping.height > 0) {
+		// clear pixels
+		sf::Image blank;
+		blank.create(clipping.width, clipping.height, sf::Color::Transparent);
+		atlas.image.copy(blank, clipping.left, clipping.top);
+		markDirty(clipping);
+		packer.release(clipping);
+		fragmented = true;
+	}
+	return true;
+}
+
+template <typename Key, typename HashFunc>
+bool IncrementalAtlas<Key, HashFunc>::defragment() {
+	// extract all frames (largest first, ties by their previous position
+	// so the layout does not depend on the hash map's order)
+	std::vector<std::pair<Key, AtlasFrame>> frames{atlas.frames.begin(), atlas.frames.end()};
+	std::sort(frames.begin(), frames.end(),
+		[](std::pair<Key, AtlasFrame> const & left, std::pair<Key, AtlasFrame> const & right) {
+		auto const & lhs = left.second.clipping;
+		auto const & rhs = right.second.clipping;
+		auto a = lhs.width * lhs.height;
+		auto b = rhs.width * rhs.height;
+		if (a != b) {
+			return a > b;
+		}
+		if (lhs.top != rhs.top) {
+			return lhs.top < rhs.top;
+		}
+		return lhs.left < rhs.left;
+	});
+	std::vector<sf::Image> images;
+	images.reserve(frames.size());
+	for (auto const & pair: frames) {
+		images.push_back(cropImage(atlas.image, pair.second.clipping));
 	}
 	
+	// pack into an empty atlas
+	IncrementalAtlas<Key, HashFunc> other{atlas.image.getSize()};
+	for (std::size_t i = 0u; i < frames.size(); ++i) {
+		auto const & clipping = frames[i].second.clipping;
+		if (!other.place(frames[i].first, images[i], {0, 0, clipping.width, clipping.height}, frames[i].second.origin)) {
+			return false;
+		}
+	}
+	atlas = std::move(other.atlas);
+	packer = std::move(other.packer);
+	fragmented = false;
+	dirty = {{0, 0}, sf::Vector2i{atlas.image.getSize()}};
 	return true;
 }
 
+template <typename Key, typename HashFunc>
+sf::IntRect IncrementalAtlas<Key, HashFunc>::getDirtyRect() const {
+	return dirty;
+}
+
+template <typename Key, typename HashFunc>
+void IncrementalAtlas<Key, HashFunc>::clearDirty() {
+	dirty = {};
+}
+
+template <typename Key, typename HashFunc>
+Atlas<Key, HashFunc> const & IncrementalAtlas<Key, HashFunc>::getAtlas() const {
+	return atlas;
+}
+
 } // ::sfext
@@ -0,0 +1,248 @@
+#pragma once
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+namespace sfext {
+
+template <typename Key, typename HashFunc>
+AtlasCache<Key, HashFunc>::AtlasCache()
+	: file{}
+	, header{nullptr}
+	, table{} {
+	static_assert(std::is_trivially_copyable<Key>::value, "Key must be trivially copyable");
+}
+
+template <typename Key, typename HashFunc>
+bool AtlasCache<Key, HashFunc>::open(std::string const & filename, std::uint64_t input_hash) {
+	header = nullptr;
+	table = FrameTable<Key, HashFunc>{};
+	if (!file.open(filename)) {
+		return false;
+	}
+	
+	// validate header
+	auto size = file.getSize();
+	auto bytes = static_cast<char const *>(file.getData());
+	if (size < sizeof(AtlasCacheHeader)) {
+		file.close();
+		return false;
+	}
+	auto tmp = reinterpret_cast<AtlasCacheHeader const *>(bytes);
+	// test whether `count` elements starting at `offset` are inside the
+	// file without risking an overflow
+	auto fits = [size](std::uint64_t offset, std::uint64_t count, std::uint64_t element) {
+		return offset <= size && count <= (size - offset) / element;
+	};
+	std::uint64_t num_pixels = tmp->width * static_cast<std::uint64_t>(tmp->height);
+	bool compressed = tmp->format != BlockFormat::None;
+	if (!compressed && !fits(0u, num_pixels, 4u)) {
+		file.close();
+		return false;
+	}
+	std::uint64_t pixels_size = compressed
+		? (tmp->width + 3u) / 4u * static_cast<std::uint64_t>((tmp->height + 3u) / 4u) * getBlockSize(tmp->format)
+		: num_pixels * 4u;
+	auto const & layout = tmp->table;
+	// note: a hashed table needs an unused slot to terminate probing
+	bool valid_table = (layout.mode == FrameTableMode::Direct && layout.num_frames <= layout.capacity)
+		|| (layout.mode == FrameTableMode::Hashed && layout.num_frames < layout.capacity
+			&& (layout.capacity & (layout.capacity - 1u)) == 0u);
+	if (std::memcmp(tmp->magic, "SFEXTATL", 8u) != 0 || tmp->version != 5u
+		|| tmp->entry_size != sizeof(Entry) || tmp->input_hash != input_hash || !valid_table
+		|| tmp->format > BlockFormat::ETC2 || tmp->pixels_size != pixels_size
+		|| !fits(tmp->frames_offset, layout.capacity, sizeof(Entry))
+		|| !fits(tmp->pixels_offset, pixels_size, 1u)
+		|| (compressed && !fits(tmp->errors_offset, layout.capacity, sizeof(float)))
+		|| !fits(tmp->hulls_offset, tmp->num_hull_vertices, sizeof(sf::Vector2f))) {
+		file.close();
+		return false;
+	}
+	
+	// the used slots have to match the number of frames, otherwise
+	// probing a hashed table might never reach an unused slot
+	auto entries = reinterpret_cast<Entry const *>(bytes + tmp->frames_offset);
+	std::uint64_t num_used{0u};
+	for (std::uint64_t i = 0u; i < layout.capacity; ++i) {
+		if (entries[i].used != 0u) {
+			++num_used;
+		}
+	}
+	if (num_used != layout.num_frames) {
+		file.close();
+		return false;
+	}
+	
+	header = tmp;
+	table.attach(entries, header->table);
+	return true;
+}
+
+template <typename Key, typename HashFunc>
+sf::Vector2u AtlasCache<Key, HashFunc>::getSize() const {
+	if (header == nullptr) {
+		return {};
+	}
+	return {header->width, header->height};
+}
+
+template <typename Key, typename HashFunc>
+sf::Uint8 const * AtlasCache<Key, HashFunc>::getPixels() const {
+	if (header == nullptr || header->format != BlockFormat::None) {
+		return nullptr;
+	}
+	return static_cast<sf::Uint8 const *>(file.getData()) + header->pixels_offset;
+}
+
+template <typename Key, typename HashFunc>
+BlockFormat AtlasCache<Key, HashFunc>::getBlockFormat() const {
+	if (header == nullptr) {
+		return BlockFormat::None;
+	}
+	return header->format;
+}
+
+template <typename Key, typename HashFunc>
+std::uint8_t const * AtlasCache<Key, HashFunc>::getBlocks() const {
+	if (header == nullptr || header->format == BlockFormat::None) {
+		return nullptr;
+	}
+	return static_cast<std::uint8_t const *>(file.getData()) + header->pixels_offset;
+}
+
+template <typename Key, typename HashFunc>
+std::size_t AtlasCache<Key, HashFunc>::getNumFrames() const {
+	return table.getNumFrames();
+}
+
+template <typename Key, typename HashFunc>
+AtlasFrame const * AtlasCache<Key, HashFunc>::find(Key const & key) const {
+	return table.find(key);
+}
+
+template <typename Key, typename HashFunc>
+float AtlasCache<Key, HashFunc>::getError(Key const & key) const {
+	auto entry = table.findEntry(key);
+	if (entry == nullptr) {
+		return -1.f;
+	}
+	if (header->format == BlockFormat::None) {
+		return 0.f;
+	}
+	// errors are stored per slot of the frame table
+	auto errors = reinterpret_cast<float const *>(static_cast<char const *>(file.getData()) + header->errors_offset);
+	return errors[entry - table.getEntries()];
+}
+
+template <typename Key, typename HashFunc>
+sf::Vector2f const * AtlasCache<Key, HashFunc>::getHulls() const {
+	if (header == nullptr) {
+		return nullptr;
+	}
+	return reinterpret_cast<sf::Vector2f const *>(static_cast<char const *>(file.getData()) + header->hulls_offset);
+}
+
+template <typename Key, typename HashFunc>
+FrameTable<Key, HashFunc> const & AtlasCache<Key, HashFunc>::getFrameTable() const {
+	return table;
+}
+
+template <typename Key, typename HashFunc>
+void AtlasCache<Key, HashFunc>::copyTo(Atlas<Key, HashFunc>& atlas) const {
+	auto size = getSize();
+	if (getBlocks() != nullptr) {
+		CompressedImage image;
+		image.format = header->format;
+		image.size = size;
+		image.blocks.assign(getBlocks(), getBlocks() + header->pixels_size);
+		atlas.image = decompressImage(image);
+	} else {
+		atlas.image.create(size.x, size.y, getPixels());
+	}
+	auto num_hull_vertices = (header != nullptr) ? header->num_hull_vertices : 0u;
+	atlas.hulls.assign(getHulls(), getHulls() + num_hull_vertices);
+	atlas.frames.clear();
+	atlas.frames.reserve(getNumFrames());
+	auto entries = table.getEntries();
+	for (std::size_t i = 0u; i < table.getLayout().capacity; ++i) {
+		if (entries[i].used != 0u) {
+			atlas.frames[entries[i].key] = entries[i].frame;
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------
+
+template <typename Key, typename HashFunc>
+bool saveAtlasCache(std::string const & filename, Atlas<Key, HashFunc> const & atlas, std::uint64_t input_hash,
+	BlockFormat format, std::size_t num_threads) {
+	static_assert(std::is_trivially_copyable<Key>::value, "Key must be trivially copyable");
+	using Entry = FrameTableEntry<Key>;
+	
+	// align sections for direct access
+	auto align = [](std::uint64_t offset, std::uint64_t alignment) {
+		return (offset + alignment - 1u) / alignment * alignment;
+	};
+	auto size = atlas.image.getSize();
+	AtlasCacheHeader header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, "SFEXTATL", 8u);
+	header.version = 5u;
+	header.entry_size = sizeof(Entry);
+	header.input_hash = input_hash;
+	header.width = size.x;
+	header.height = size.y;
+	header.format = format;
+	FrameTable<Key, HashFunc> table{atlas.frames};
+	header.table = table.getLayout();
+	header.frames_offset = align(sizeof(header), 64u);
+	auto table_size = header.table.capacity * sizeof(Entry);
+	header.pixels_offset = align(header.frames_offset + table_size, 64u);
+	auto pixels = reinterpret_cast<char const *>(atlas.image.getPixelsPtr());
+	header.pixels_size = 4u * static_cast<std::uint64_t>(size.x) * size.y;
+	
+	// compress pixels and measure each frame's error
+	CompressedImage compressed;
+	std::vector<float> errors;
+	if (format != BlockFormat::None) {
+		compressed = compressImage(atlas.image, format, num_threads);
+		pixels = reinterpret_cast<char const *>(compressed.blocks.data());
+		header.pixels_size = compressed.blocks.size();
+		auto decoded = decompressImage(compressed, num_threads);
+		errors.resize(header.table.capacity, 0.f);
+		auto entries = table.getEntries();
+		for (std::size_t i = 0u; i < errors.size(); ++i) {
+			if (entries[i].used != 0u) {
+				errors[i] = getCompressionError(atlas.image, decoded, entries[i].frame.clipping);
+			}
+		}
+	}
+	header.hulls_offset = align(header.pixels_offset + header.pixels_size, 64u);
+	header.num_hull_vertices = atlas.hulls.size();
+	auto hulls_size = header.num_hull_vertices * sizeof(sf::Vector2f);
+	header.errors_offset = errors.empty() ? 0u : align(header.hulls_offset + hulls_size, 64u);
+	
+	std::ofstream out{filename, std::ios::binary};
+	if (!out) {
+		return false;
+	}
+	std::vector<char> padding(64u, 0);
+	out.write(reinterpret_cast<char const *>(&header), sizeof(header));
+	out.write(padding.data(), header.frames_offset - sizeof(header));
+	out.write(reinterpret_cast<char const *>(table.getEntries()), table_size);
+	out.write(padding.data(), header.pixels_offset - header.frames_offset - table_size);
+	if (header.pixels_size > 0u) {
+		out.write(pixels, header.pixels_size);
+	}
+	out.write(padding.data(), header.hulls_offset - header.pixels_offset - header.pixels_size);
+	if (!atlas.hulls.empty()) {
+		out.write(reinterpret_cast<char const *>(atlas.hulls.data()), hulls_size);
+	}
+	if (!errors.empty()) {
+		out.write(padding.data(), header.errors_offset - header.hulls_offset - hulls_size);
+		out.write(reinterpret_cast<char const *>(errors.data()), errors.size() * sizeof(float));
+	}
+	return static_cast<bool>(out);
+}
+
+} // ::sfext
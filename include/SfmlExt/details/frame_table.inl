@@ -0,0 +1,168 @@
+#pragma once
+#include <algorithm>
+
+namespace sfext {
+
+template <typename Key>
+typename std::enable_if<std::is_integral<Key>::value || std::is_enum<Key>::value, bool>::type
+toFrameIndex(Key const & key, std::int64_t& value) {
+	value = static_cast<std::int64_t>(key);
+	return true;
+}
+
+template <typename Key>
+typename std::enable_if<!std::is_integral<Key>::value && !std::is_enum<Key>::value, bool>::type
+toFrameIndex(Key const &, std::int64_t&) {
+	return false;
+}
+
+// ---------------------------------------------------------------------------
+
+template <typename Key, typename HashFunc>
+FrameTable<Key, HashFunc>::FrameTable()
+	: storage{}
+	, external{nullptr}
+	, layout{FrameTableMode::Direct, 0u, 0, 0u, 0u}
+	, hash{} {
+}
+
+template <typename Key, typename HashFunc>
+FrameTable<Key, HashFunc>::FrameTable(std::unordered_map<Key, AtlasFrame, HashFunc> const & frames)
+	: FrameTable{} {
+	build(frames);
+}
+
+template <typename Key, typename HashFunc>
+typename FrameTable<Key, HashFunc>::Entry const * FrameTable<Key, HashFunc>::getSlots() const {
+	return (external != nullptr) ? external : storage.data();
+}
+
+template <typename Key, typename HashFunc>
+std::size_t FrameTable<Key, HashFunc>::getHome(Key const & key) const {
+	// scramble the hash, because e.g. std::hash<int> is the identity
+	std::uint64_t value = hash(key);
+	value ^= value >> 33u;
+	value *= 0xff51afd7ed558ccdull;
+	value ^= value >> 33u;
+	return static_cast<std::size_t>(value & (layout.capacity - 1u));
+}
+
+template <typename Key, typename HashFunc>
+void FrameTable<Key, HashFunc>::build(std::unordered_map<Key, AtlasFrame, HashFunc> const & frames) {
+	external = nullptr;
+	storage.clear();
+	layout = FrameTableLayout{FrameTableMode::Direct, 0u, 0, 0u, frames.size()};
+	if (frames.empty()) {
+		return;
+	}
+
+	// determine key range of integral keys
+	bool integral{true}, first{true};
+	std::int64_t min{0}, max{0};
+	for (auto const & pair: frames) {
+		std::int64_t value{0};
+		if (!toFrameIndex(pair.first, value)) {
+			integral = false;
+			break;
+		}
+		min = first ? value : std::min(min, value);
+		max = first ? value : std::max(max, value);
+		first = false;
+	}
+	auto range = static_cast<std::uint64_t>(max) - static_cast<std::uint64_t>(min) + 1u;
+	if (integral && range != 0u && range <= 2u * frames.size()) {
+		layout.mode = FrameTableMode::Direct;
+		layout.key_base = min;
+		layout.capacity = range;
+	} else {
+		layout.mode = FrameTableMode::Hashed;
+		layout.capacity = 1u;
+		while (layout.capacity < 2u * frames.size()) {
+			layout.capacity *= 2u;
+		}
+	}
+
+	// note: value-initialized slots have zeroed padding bytes
+	storage.resize(layout.capacity);
+	for (auto const & pair: frames) {
+		std::size_t index;
+		if (layout.mode == FrameTableMode::Direct) {
+			std::int64_t value{0};
+			toFrameIndex(pair.first, value);
+			index = static_cast<std::size_t>(static_cast<std::uint64_t>(value) - static_cast<std::uint64_t>(min));
+		} else {
+			index = getHome(pair.first);
+			while (storage[index].used != 0u) {
+				index = (index + 1u) & (layout.capacity - 1u);
+			}
+		}
+		auto& entry = storage[index];
+		entry.key = pair.first;
+		entry.used = 1u;
+		// note: assigned field by field, so the (zeroed) padding bytes are not
+		// overwritten with uninitialized ones and saved tables are reproducible
+		auto const & frame = pair.second;
+		entry.frame.clipping = frame.clipping;
+		entry.frame.origin = frame.origin;
+		entry.frame.page = frame.page;
+		entry.frame.rotated = frame.rotated;
+		entry.frame.hull_offset = frame.hull_offset;
+		entry.frame.hull_size = frame.hull_size;
+	}
+}
+
+template <typename Key, typename HashFunc>
+void FrameTable<Key, HashFunc>::attach(Entry const * entries, FrameTableLayout const & layout) {
+	storage.clear();
+	external = entries;
+	this->layout = layout;
+}
+
+template <typename Key, typename HashFunc>
+typename FrameTable<Key, HashFunc>::Entry const * FrameTable<Key, HashFunc>::findEntry(Key const & key) const {
+	if (layout.capacity == 0u) {
+		return nullptr;
+	}
+	auto slots = getSlots();
+	if (layout.mode == FrameTableMode::Direct) {
+		std::int64_t value{0};
+		if (!toFrameIndex(key, value)) {
+			return nullptr;
+		}
+		auto index = static_cast<std::uint64_t>(value) - static_cast<std::uint64_t>(layout.key_base);
+		if (index >= layout.capacity || slots[index].used == 0u) {
+			return nullptr;
+		}
+		return &slots[index];
+	}
+	// probe until an unused slot is found (the table is never full)
+	for (auto index = getHome(key); slots[index].used != 0u; index = (index + 1u) & (layout.capacity - 1u)) {
+		if (slots[index].key == key) {
+			return &slots[index];
+		}
+	}
+	return nullptr;
+}
+
+template <typename Key, typename HashFunc>
+AtlasFrame const * FrameTable<Key, HashFunc>::find(Key const & key) const {
+	auto entry = findEntry(key);
+	return (entry != nullptr) ? &entry->frame : nullptr;
+}
+
+template <typename Key, typename HashFunc>
+std::size_t FrameTable<Key, HashFunc>::getNumFrames() const {
+	return layout.num_frames;
+}
+
+template <typename Key, typename HashFunc>
+FrameTableLayout const & FrameTable<Key, HashFunc>::getLayout() const {
+	return layout;
+}
+
+template <typename Key, typename HashFunc>
+typename FrameTable<Key, HashFunc>::Entry const * FrameTable<Key, HashFunc>::getEntries() const {
+	return getSlots();
+}
+
+} // ::sfext
@@ -0,0 +1,61 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sfext {
+
+inline std::size_t getNumThreads(std::size_t num_threads) {
+	if (num_threads == 0u) {
+		num_threads = std::thread::hardware_concurrency();
+	}
+	return std::max<std::size_t>(num_threads, 1u);
+}
+
+template <typename Func>
+void parallelFor(std::size_t num_items, std::size_t num_threads, Func func) {
+	num_threads = std::min(getNumThreads(num_threads), num_items);
+	if (num_threads <= 1u) {
+		// nothing to distribute
+		for (std::size_t i = 0u; i < num_items; ++i) {
+			func(i);
+		}
+		return;
+	}
+
+	std::atomic<std::size_t> next{0u};
+	std::exception_ptr error{nullptr};
+	std::mutex mutex;
+	auto worker = [&]() {
+		try {
+			for (auto i = next++; i < num_items; i = next++) {
+				func(i);
+			}
+		} catch (...) {
+			std::lock_guard<std::mutex> lock{mutex};
+			if (error == nullptr) {
+				error = std::current_exception();
+			}
+			// let all workers stop
+			next = num_items;
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(num_threads - 1u);
+	for (std::size_t i = 1u; i < num_threads; ++i) {
+		threads.emplace_back(worker);
+	}
+	worker();
+	for (auto& thread: threads) {
+		thread.join();
+	}
+	if (error != nullptr) {
+		std::rethrow_exception(error);
+	}
+}
+
+} // ::sfext
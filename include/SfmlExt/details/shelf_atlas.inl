@@ -0,0 +1,294 @@
+#pragma once
+#include <algorithm>
+
+namespace sfext {
+
+template <typename Key, typename HashFunc>
+ShelfAtlas<Key, HashFunc>::ShelfAtlas(sf::Vector2u const & size)
+	: image{}
+	, entries{}
+	, lru{}
+	, shelves{}
+	, bottom{0}
+	, dirty_top{0}
+	, dirty_bottom{0}
+	, stats{0u, 0u, 0u, 0u} {
+	image.create(size.x, size.y, sf::Color::Transparent);
+}
+
+template <typename Key, typename HashFunc>
+std::size_t ShelfAtlas<Key, HashFunc>::getShelf(int top) const {
+	auto i = std::lower_bound(shelves.begin(), shelves.end(), top, [](Shelf const & shelf, int top) {
+		return shelf.top < top;
+	});
+	return static_cast<std::size_t>(i - shelves.begin());
+}
+
+template <typename Key, typename HashFunc>
+bool ShelfAtlas<Key, HashFunc>::allocate(sf::Vector2i const & size, sf::IntRect& slot) {
+	auto width = static_cast<int>(image.getSize().x);
+	auto height = static_cast<int>(image.getSize().y);
+	auto is_empty = [width](Shelf const & shelf) {
+		return shelf.spans.size() == 1u && shelf.spans[0].x == 0 && shelf.spans[0].y == width;
+	};
+	auto take = [&](std::size_t index) {
+		// first fit inside the shelf
+		auto& shelf = shelves[index];
+		for (auto i = shelf.spans.begin(); i != shelf.spans.end(); ++i) {
+			if (i->y >= size.x) {
+				slot = {i->x, shelf.top, size.x, shelf.height};
+				i->x += size.x;
+				i->y -= size.x;
+				if (i->y == 0) {
+					shelf.spans.erase(i);
+				}
+				return true;
+			}
+		}
+		return false;
+	};
+
+	// best fitting shelf in use (wasting at most half the frame's height)
+	auto max_waste = std::max(size.y / 2, 2);
+	auto best_waste = max_waste + 1;
+	auto best_index = shelves.size();
+	for (std::size_t i = 0u; i < shelves.size(); ++i) {
+		auto const & shelf = shelves[i];
+		auto waste = shelf.height - size.y;
+		if (waste < 0 || waste >= best_waste || is_empty(shelf)) {
+			continue;
+		}
+		for (auto const & span: shelf.spans) {
+			if (span.y >= size.x) {
+				best_waste = waste;
+				best_index = i;
+				break;
+			}
+		}
+	}
+	if (best_index < shelves.size()) {
+		return take(best_index);
+	}
+
+	// open new shelf below all others
+	if (bottom + size.y <= height) {
+		shelves.push_back({bottom, size.y, {{0, width}}});
+		bottom += size.y;
+		return take(shelves.size() - 1u);
+	}
+
+	// reuse smallest empty shelf
+	best_index = shelves.size();
+	for (std::size_t i = 0u; i < shelves.size(); ++i) {
+		if (is_empty(shelves[i]) && shelves[i].height >= size.y
+			&& (best_index == shelves.size() || shelves[i].height < shelves[best_index].height)) {
+			best_index = i;
+		}
+	}
+	if (best_index == shelves.size()) {
+		return false;
+	}
+	auto& shelf = shelves[best_index];
+	if (shelf.height > size.y) {
+		// split off remaining height as another empty shelf
+		Shelf rest{shelf.top + size.y, shelf.height - size.y, {{0, width}}};
+		shelf.height = size.y;
+		shelves.insert(shelves.begin() + best_index + 1u, rest);
+	}
+	return take(best_index);
+}
+
+template <typename Key, typename HashFunc>
+void ShelfAtlas<Key, HashFunc>::release(sf::IntRect const & rect) {
+	auto width = static_cast<int>(image.getSize().x);
+	auto is_empty = [width](Shelf const & shelf) {
+		return shelf.spans.size() == 1u && shelf.spans[0].x == 0 && shelf.spans[0].y == width;
+	};
+	auto index = getShelf(rect.top);
+	auto& spans = shelves[index].spans;
+
+	// insert span and merge with neighbours
+	auto i = std::lower_bound(spans.begin(), spans.end(), rect.left, [](sf::Vector2i const & span, int x) {
+		return span.x < x;
+	});
+	i = spans.insert(i, {rect.left, rect.width});
+	auto next = i + 1;
+	if (next != spans.end() && i->x + i->y == next->x) {
+		i->y += next->y;
+		spans.erase(next);
+	}
+	if (i != spans.begin()) {
+		auto prev = i - 1;
+		if (prev->x + prev->y == i->x) {
+			prev->y += i->y;
+			spans.erase(i);
+		}
+	}
+	if (!is_empty(shelves[index])) {
+		return;
+	}
+
+	// merge adjacent empty shelves
+	if (index + 1u < shelves.size() && is_empty(shelves[index + 1u])) {
+		shelves[index].height += shelves[index + 1u].height;
+		shelves.erase(shelves.begin() + index + 1u);
+	}
+	if (index > 0u && is_empty(shelves[index - 1u])) {
+		shelves[index - 1u].height += shelves[index].height;
+		shelves.erase(shelves.begin() + index);
+	}
+	// give trailing empty space back
+	if (!shelves.empty() && is_empty(shelves.back())) {
+		bottom = shelves.back().top;
+		shelves.pop_back();
+	}
+}
+
+template <typename Key, typename HashFunc>
+bool ShelfAtlas<Key, HashFunc>::evict() {
+	if (lru.empty()) {
+		return false;
+	}
+	erase(lru.back());
+	++stats.evictions;
+	return true;
+}
+
+template <typename Key, typename HashFunc>
+AtlasFrame const * ShelfAtlas<Key, HashFunc>::find(Key const & key) {
+	auto i = entries.find(key);
+	if (i == entries.end()) {
+		++stats.misses;
+		return nullptr;
+	}
+	++stats.hits;
+	lru.splice(lru.begin(), lru, i->second.lru);
+	return &i->second.frame;
+}
+
+template <typename Key, typename HashFunc>
+AtlasFrame const * ShelfAtlas<Key, HashFunc>::insert(Key const & key, sf::Image const & image, sf::Vector2f origin) {
+	// shrink to non-transparent pixels
+	auto bounds = getOpaqueBounds(image);
+	origin.x -= bounds.left;
+	origin.y -= bounds.top;
+	auto size = sf::Vector2i{this->image.getSize()};
+	if (bounds.width > size.x || bounds.height > size.y) {
+		// note: an existing frame is kept
+		return nullptr;
+	}
+	erase(key);
+
+	AtlasFrame frame;
+	frame.clipping = {0, 0, bounds.width, bounds.height};
+	frame.origin = origin;
+	frame.page = 0u;
+	frame.rotated = false;
+	frame.hull_offset = 0u;
+	frame.hull_size = 0u;
+	if (bounds.width > 0 && bounds.height > 0) {
+		sf::IntRect slot;
+		while (!allocate({bounds.width, bounds.height}, slot)) {
+			if (!evict()) {
+				return nullptr;
+			}
+		}
+		frame.clipping.left = slot.left;
+		frame.clipping.top = slot.top;
+		blitImage(this->image, {slot.left, slot.top}, image, bounds);
+		if (slot.height > bounds.height) {
+			// clear pixels of evicted frames below the frame
+			sf::Image blank;
+			blank.create(slot.width, slot.height - bounds.height, sf::Color::Transparent);
+			this->image.copy(blank, slot.left, slot.top + bounds.height);
+		}
+
+		// extend dirty rows
+		if (dirty_top == dirty_bottom) {
+			dirty_top = slot.top;
+			dirty_bottom = slot.top + slot.height;
+		} else {
+			dirty_top = std::min(dirty_top, slot.top);
+			dirty_bottom = std::max(dirty_bottom, slot.top + slot.height);
+		}
+	}
+
+	lru.push_front(key);
+	auto& entry = entries[key];
+	entry.frame = frame;
+	entry.lru = lru.begin();
+	++stats.insertions;
+	return &entry.frame;
+}
+
+template <typename Key, typename HashFunc>
+bool ShelfAtlas<Key, HashFunc>::erase(Key const & key) {
+	auto i = entries.find(key);
+	if (i == entries.end()) {
+		return false;
+	}
+	auto clipping = i->second.frame.clipping;
+	lru.erase(i->second.lru);
+	entries.erase(i);
+	if (clipping.width > 0 && clipping.height > 0) {
+		// note: pixels are kept until the space is reused
+		release(clipping);
+	}
+	return true;
+}
+
+template <typename Key, typename HashFunc>
+void ShelfAtlas<Key, HashFunc>::clear() {
+	entries.clear();
+	lru.clear();
+	shelves.clear();
+	bottom = 0;
+}
+
+template <typename Key, typename HashFunc>
+std::size_t ShelfAtlas<Key, HashFunc>::getNumFrames() const {
+	return entries.size();
+}
+
+template <typename Key, typename HashFunc>
+sf::Image const & ShelfAtlas<Key, HashFunc>::getImage() const {
+	return image;
+}
+
+template <typename Key, typename HashFunc>
+sf::IntRect ShelfAtlas<Key, HashFunc>::getDirtyRect() const {
+	if (dirty_top == dirty_bottom) {
+		return {};
+	}
+	return {0, dirty_top, static_cast<int>(image.getSize().x), dirty_bottom - dirty_top};
+}
+
+template <typename Key, typename HashFunc>
+void ShelfAtlas<Key, HashFunc>::clearDirty() {
+	dirty_top = 0;
+	dirty_bottom = 0;
+}
+
+template <typename Key, typename HashFunc>
+void ShelfAtlas<Key, HashFunc>::update(sf::Texture& texture) {
+	auto dirty = getDirtyRect();
+	if (dirty.height == 0) {
+		return;
+	}
+	// rows are contiguous, so they are uploaded without copying
+	auto width = image.getSize().x;
+	texture.update(image.getPixelsPtr() + 4u * width * dirty.top, width, dirty.height, 0u, dirty.top);
+	clearDirty();
+}
+
+template <typename Key, typename HashFunc>
+ShelfAtlasStats const & ShelfAtlas<Key, HashFunc>::getStats() const {
+	return stats;
+}
+
+template <typename Key, typename HashFunc>
+void ShelfAtlas<Key, HashFunc>::resetStats() {
+	stats = ShelfAtlasStats{0u, 0u, 0u, 0u};
+}
+
+} // ::sfext
@@ -0,0 +1,109 @@
+#pragma once
+#include <algorithm>
+#include <utility>
+
+namespace sfext {
+
+template <typename Key, GridMode M, typename HashFunc>
+TileBatch<Key, M, HashFunc>::TileBatch(FrameTable<Key, HashFunc> const & frames, std::size_t num_layers, TileFunc tiles)
+	: frames(frames)
+	, tiles{std::move(tiles)}
+	, layers(num_layers, std::vector<sf::VertexArray>(1u, sf::VertexArray{sf::Quads}))
+	, spans{}
+	, current{}
+	, tile_size{}
+	, dirty{true}
+	, num_rebuilds{0u} {
+}
+
+template <typename Key, GridMode M, typename HashFunc>
+void TileBatch<Key, M, HashFunc>::rebuild(Tiling<M> const & tiling) {
+	for (auto& layer: layers) {
+		for (auto& page: layer) {
+			page.clear();
+		}
+	}
+	Key key{};
+	for (auto const & span: spans) {
+		for (auto x = span.x_begin; x < span.x_end; ++x) {
+			auto tile = Tiling<M>::getTile(span, x);
+			auto screen_pos = tiling.toScreen(sf::Vector2f{tile});
+			// note: positions left or above the map wrap around
+			sf::Vector2u pos{static_cast<unsigned int>(tile.x), static_cast<unsigned int>(tile.y)};
+			for (std::size_t i = 0u; i < layers.size(); ++i) {
+				if (!tiles(pos, i, key)) {
+					continue;
+				}
+				auto frame = frames.find(key);
+				if (frame == nullptr) {
+					continue;
+				}
+				// quad in original (unrotated) orientation
+				sf::Vector2f size{static_cast<float>(frame->clipping.width), static_cast<float>(frame->clipping.height)};
+				if (frame->rotated) {
+					std::swap(size.x, size.y);
+				}
+				auto left = screen_pos - frame->origin;
+				sf::Vector2f corners[4] = {left, {left.x + size.x, left.y}, left + size, {left.x, left.y + size.y}};
+				auto tex_coords = getTexCoords(*frame);
+				if (frame->page >= layers[i].size()) {
+					// keep the number of pages equal for all layers
+					for (auto& layer: layers) {
+						layer.resize(frame->page + 1u, sf::VertexArray{sf::Quads});
+					}
+				}
+				auto& vertices = layers[i][frame->page];
+				for (std::size_t j = 0u; j < 4u; ++j) {
+					vertices.append(sf::Vertex{corners[j], sf::Color::White, tex_coords[j]});
+				}
+			}
+		}
+	}
+	++num_rebuilds;
+}
+
+template <typename Key, GridMode M, typename HashFunc>
+void TileBatch<Key, M, HashFunc>::invalidate() {
+	dirty = true;
+}
+
+template <typename Key, GridMode M, typename HashFunc>
+bool TileBatch<Key, M, HashFunc>::update(Tiling<M> const & tiling) {
+	// the visible tiles only change if the view crosses a tile boundary
+	tiling.getSpans(current);
+	auto current_tile_size = tiling.getTileSize();
+	auto same = current.size() == spans.size() && std::equal(current.begin(), current.end(), spans.begin(),
+		[](TileSpan const & lhs, TileSpan const & rhs) {
+		return lhs.row == rhs.row && lhs.x_begin == rhs.x_begin && lhs.x_end == rhs.x_end;
+	});
+	if (!dirty && same && current_tile_size == tile_size) {
+		return false;
+	}
+	std::swap(spans, current);
+	tile_size = current_tile_size;
+	dirty = false;
+	rebuild(tiling);
+	return true;
+}
+
+template <typename Key, GridMode M, typename HashFunc>
+std::size_t TileBatch<Key, M, HashFunc>::getNumLayers() const {
+	return layers.size();
+}
+
+template <typename Key, GridMode M, typename HashFunc>
+std::size_t TileBatch<Key, M, HashFunc>::getNumPages() const {
+	return layers.empty() ? 1u : layers.front().size();
+}
+
+template <typename Key, GridMode M, typename HashFunc>
+sf::VertexArray const & TileBatch<Key, M, HashFunc>::getLayer(std::size_t layer, std::size_t page) const {
+	return layers[layer][page];
+}
+
+template <typename Key, GridMode M, typename HashFunc>
+std::size_t TileBatch<Key, M, HashFunc>::getNumRebuilds() const {
+	return num_rebuilds;
+}
+
+} // ::sfext
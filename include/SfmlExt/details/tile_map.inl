@@ -0,0 +1,150 @@
+#pragma once
+#include <stdexcept>
+
+namespace sfext {
+
+template <typename Map>
+TileMapIterator<Map>::TileMapIterator(Map& map, TilingIterator<Map::mode> const & current,
+	TilingIterator<Map::mode> const & last)
+	: map{&map}
+	, current{current}
+	, last{last} {
+	skip();
+}
+
+template <typename Map>
+void TileMapIterator<Map>::skip() {
+	// note: positions left or above the map wrap around and are skipped as well
+	while (current != last && !map->contains(*current)) {
+		++current;
+	}
+}
+
+template <typename Map>
+auto TileMapIterator<Map>::operator*() const -> decltype(std::declval<Map&>()[sf::Vector2u{}]) {
+	return (*map)[*current];
+}
+
+template <typename Map>
+bool TileMapIterator<Map>::operator!=(TileMapIterator<Map> const & other) const {
+	return current != other.current;
+}
+
+template <typename Map>
+void TileMapIterator<Map>::operator++() {
+	++current;
+	skip();
+}
+
+template <typename Map>
+sf::Vector2u TileMapIterator<Map>::getPosition() const {
+	return *current;
+}
+
+// ---------------------------------------------------------------------------
+
+template <typename Map>
+TileMapRange<Map>::TileMapRange(Map& map, Tiling<Map::mode> const & tiling)
+	: map{&map}
+	, first{sfext::begin(tiling)}
+	, last{sfext::end(tiling)} {
+}
+
+template <typename Map>
+TileMapIterator<Map> TileMapRange<Map>::begin() const {
+	return {*map, first, last};
+}
+
+template <typename Map>
+TileMapIterator<Map> TileMapRange<Map>::end() const {
+	return {*map, last, last};
+}
+
+// ---------------------------------------------------------------------------
+
+template <typename T, GridMode M>
+GridMode const TileMap<T, M>::mode;
+
+template <typename T, GridMode M>
+unsigned int const TileMap<T, M>::chunk_bits;
+
+template <typename T, GridMode M>
+unsigned int const TileMap<T, M>::chunk_size;
+
+template <typename T, GridMode M>
+TileMap<T, M>::TileMap(sf::Vector2u const & size, T const & value)
+	: size{size}
+	, num_chunks_x{(size.x + chunk_size - 1u) / chunk_size}
+	, tiles{} {
+	for (auto i = 0u; i < chunk_size; ++i) {
+		spread[i] = spreadBits(i);
+	}
+	auto num_chunks_y = (size.y + chunk_size - 1u) / chunk_size;
+	tiles.resize(static_cast<std::size_t>(num_chunks_x) * num_chunks_y * chunk_size * chunk_size, value);
+}
+
+template <typename T, GridMode M>
+std::uint32_t TileMap<T, M>::spreadBits(std::uint32_t value) {
+	value &= 0x0000FFFFu;
+	value = (value | (value << 8u)) & 0x00FF00FFu;
+	value = (value | (value << 4u)) & 0x0F0F0F0Fu;
+	value = (value | (value << 2u)) & 0x33333333u;
+	value = (value | (value << 1u)) & 0x55555555u;
+	return value;
+}
+
+template <typename T, GridMode M>
+std::size_t TileMap<T, M>::getIndex(sf::Vector2u const & pos) const {
+	auto chunk = static_cast<std::size_t>(pos.y >> chunk_bits) * num_chunks_x + (pos.x >> chunk_bits);
+	auto mask = chunk_size - 1u;
+	auto local = spread[pos.x & mask] | (spread[pos.y & mask] << 1u);
+	return chunk * chunk_size * chunk_size + local;
+}
+
+template <typename T, GridMode M>
+sf::Vector2u TileMap<T, M>::getSize() const {
+	return size;
+}
+
+template <typename T, GridMode M>
+bool TileMap<T, M>::contains(sf::Vector2u const & pos) const {
+	return pos.x < size.x && pos.y < size.y;
+}
+
+template <typename T, GridMode M>
+T& TileMap<T, M>::operator[](sf::Vector2u const & pos) {
+	return tiles[getIndex(pos)];
+}
+
+template <typename T, GridMode M>
+T const & TileMap<T, M>::operator[](sf::Vector2u const & pos) const {
+	return tiles[getIndex(pos)];
+}
+
+template <typename T, GridMode M>
+T& TileMap<T, M>::at(sf::Vector2u const & pos) {
+	if (!contains(pos)) {
+		throw std::out_of_range("Tile position outside the map");
+	}
+	return tiles[getIndex(pos)];
+}
+
+template <typename T, GridMode M>
+T const & TileMap<T, M>::at(sf::Vector2u const & pos) const {
+	if (!contains(pos)) {
+		throw std::out_of_range("Tile position outside the map");
+	}
+	return tiles[getIndex(pos)];
+}
+
+template <typename T, GridMode M>
+TileMapRange<TileMap<T, M>> TileMap<T, M>::getVisible(Tiling<M> const & tiling) {
+	return {*this, tiling};
+}
+
+template <typename T, GridMode M>
+TileMapRange<TileMap<T, M> const> TileMap<T, M>::getVisible(Tiling<M> const & tiling) const {
+	return {*this, tiling};
+}
+
+} // ::sfext
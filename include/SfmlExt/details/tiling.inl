@@ -1,5 +1,10 @@
 #pragma once
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
 
 namespace sfext {
 
@@ -41,7 +46,7 @@ inline void TilingIterator<GridMode::IsoDiamond>::operator++() {
 	--current.y;
 	++current.x;
 	++count;
-	if (count > range.x) {
+	if (count > static_cast<unsigned int>(range.x)) {
 		// go to next screen row --> zigzag
 		if ((current.x + current.y) % 2 == 0u) {
 			++start.y;
@@ -92,10 +97,90 @@ sf::View Tiling<M>::getView() const {
 	return view;
 }
 
+template <GridMode M>
+void Tiling<M>::getViewCorners(sf::Vector2f corners[4]) const {
+	// the visible area is the view's rectangle rotated around its center
+	auto angle = view.getRotation() * 3.14159265f / 180.f;
+	auto cosine = std::cos(angle);
+	auto sine = std::sin(angle);
+	auto center = view.getCenter();
+	auto half = view.getSize() / 2.f;
+	sf::Vector2f const local[4] = {{-half.x, -half.y}, {half.x, -half.y}, {half.x, half.y}, {-half.x, half.y}};
+	for (int i = 0; i < 4; ++i) {
+		corners[i].x = center.x + cosine * local[i].x - sine * local[i].y;
+		corners[i].y = center.y + sine * local[i].x + cosine * local[i].y;
+	}
+}
+
+template <GridMode M>
+sf::Vector2f Tiling<M>::getViewExtent() const {
+	if (view.getRotation() == 0.f) {
+		return view.getSize();
+	}
+	// bounding box of the rotated view
+	sf::Vector2f corners[4];
+	getViewCorners(corners);
+	sf::Vector2f low{corners[0]}, high{corners[0]};
+	for (auto const & corner: corners) {
+		low.x = std::min(low.x, corner.x);
+		low.y = std::min(low.y, corner.y);
+		high.x = std::max(high.x, corner.x);
+		high.y = std::max(high.y, corner.y);
+	}
+	return high - low;
+}
+
+template <GridMode M>
+void Tiling<M>::scanView(std::vector<TileSpan>& spans, float row_step, float shift) const {
+	spans.clear();
+	sf::Vector2f corners[4];
+	getViewCorners(corners);
+	
+	// tiles are culled by their (padded) screen bounding box around their center
+	auto half_width = tile_size.x / 2.f + padding.x * tile_size.x;
+	auto half_height = tile_size.y / 2.f + padding.y * tile_size.y;
+	auto top = std::min(std::min(corners[0].y, corners[1].y), std::min(corners[2].y, corners[3].y));
+	auto bottom = std::max(std::max(corners[0].y, corners[1].y), std::max(corners[2].y, corners[3].y));
+	auto first = static_cast<int>(std::floor((top - half_height) / row_step)) + 1;
+	auto last = static_cast<int>(std::ceil((bottom + half_height) / row_step));
+	for (auto row = first; row < last; ++row) {
+		// horizontal extent of the view inside the row's strip
+		auto strip_top = row * row_step - half_height;
+		auto strip_bottom = row * row_step + half_height;
+		auto left = std::numeric_limits<float>::max();
+		auto right = std::numeric_limits<float>::lowest();
+		for (int i = 0; i < 4; ++i) {
+			auto const & p = corners[i];
+			auto const & q = corners[(i + 1) % 4];
+			if (p.y >= strip_top && p.y <= strip_bottom) {
+				left = std::min(left, p.x);
+				right = std::max(right, p.x);
+			}
+			for (auto y: {strip_top, strip_bottom}) {
+				if ((p.y - y) * (q.y - y) < 0.f) {
+					auto x = p.x + (q.x - p.x) * (y - p.y) / (q.y - p.y);
+					left = std::min(left, x);
+					right = std::max(right, x);
+				}
+			}
+		}
+		if (left > right) {
+			continue;
+		}
+		// tiles whose bounding box overlaps that extent
+		auto offset = row * shift;
+		auto x_begin = static_cast<int>(std::floor((left - half_width - offset) / tile_size.x)) + 1;
+		auto x_end = static_cast<int>(std::ceil((right + half_width - offset) / tile_size.x));
+		if (x_begin < x_end) {
+			spans.push_back({row, x_begin, x_end});
+		}
+	}
+}
+
 // specialization for orthogonal maps
 template<>
 inline sf::Vector2u Tiling<GridMode::Orthogonal>::getRange() const {
-	auto size = view.getSize();
+	auto size = getViewExtent();
 	sf::Vector2u range;
 	
 	// calculate range
@@ -109,20 +194,38 @@ inline sf::Vector2u Tiling<GridMode::Orthogonal>::getRange() const {
 	return range;
 }
 
+template <GridMode M>
+bool Tiling<M>::getDiamondBounds(int& first_row, int& last_row, int& left, int& width) const {
+	// bounds of the visible (padded) tiles' screen rows and columns
+	std::vector<TileSpan> spans;
+	scanView(spans, tile_size.y / 2.f, -tile_size.x / 2.f);
+	if (spans.empty()) {
+		return false;
+	}
+	first_row = spans.front().row;
+	last_row = spans.back().row;
+	auto min_column = std::numeric_limits<int>::max();
+	auto max_column = std::numeric_limits<int>::lowest();
+	for (auto const & span: spans) {
+		// column of tile (x, row - x) is 2 * x - row
+		min_column = std::min(min_column, 2 * span.x_begin - span.row);
+		max_column = std::max(max_column, 2 * (span.x_end - 1) - span.row);
+	}
+	// zigzag: even rows start at an even column, odd rows one column left of it
+	left = min_column + 1;
+	left -= ((left % 2) + 2) % 2;
+	width = (max_column - (left - 1) + 1) / 2;
+	return true;
+}
+
 // specialization for isometric (diamond) maps
 template<>
 inline sf::Vector2u Tiling<GridMode::IsoDiamond>::getRange() const {
-	auto size = view.getSize();
-	sf::Vector2u range;
-	
-	// calculate range
-	// size + 2 : because tile might be rendered centered (else: gap at bottom/right)
-	// size + 2 : because topleft starts 2 rows above (see topleft calc)
-	// height x 2 : because of vertical zig-zag
-	range.x =  static_cast<unsigned int>(std::ceil(size.x / tile_size.x)) + 2 + 2;
-	range.y = (static_cast<unsigned int>(std::ceil(size.y / tile_size.y)) + 2 + 2) * 2;
-	
-	return range;
+	int first_row, last_row, left, width;
+	if (!getDiamondBounds(first_row, last_row, left, width)) {
+		return {0u, 0u};
+	}
+	return {static_cast<unsigned int>(width), static_cast<unsigned int>(last_row - first_row + 1)};
 }
 
 // specialization for orthogonal maps
@@ -155,6 +258,97 @@ inline sf::Vector2f Tiling<GridMode::IsoDiamond>::fromScreen(sf::Vector2f const
 	};
 }
 
+// specialization for orthogonal maps
+template<>
+inline void Tiling<GridMode::Orthogonal>::toScreen(float const * world_x, float const * world_y, float* screen_x,
+	float* screen_y, std::size_t num) const {
+	std::size_t i{0u};
+#if defined(__SSE2__) || defined(_M_X64)
+	auto const tx = _mm_set1_ps(tile_size.x);
+	auto const ty = _mm_set1_ps(tile_size.y);
+	for (; i + 4u <= num; i += 4u) {
+		auto x = _mm_loadu_ps(world_x + i);
+		auto y = _mm_loadu_ps(world_y + i);
+		_mm_storeu_ps(screen_x + i, _mm_mul_ps(x, tx));
+		_mm_storeu_ps(screen_y + i, _mm_mul_ps(y, ty));
+	}
+#endif
+	for (; i < num; ++i) {
+		auto pos = toScreen(sf::Vector2f{world_x[i], world_y[i]});
+		screen_x[i] = pos.x;
+		screen_y[i] = pos.y;
+	}
+}
+
+// specialization for isometric (diamond) maps
+template<>
+inline void Tiling<GridMode::IsoDiamond>::toScreen(float const * world_x, float const * world_y, float* screen_x,
+	float* screen_y, std::size_t num) const {
+	std::size_t i{0u};
+#if defined(__SSE2__) || defined(_M_X64)
+	auto const tx = _mm_set1_ps(tile_size.x);
+	auto const ty = _mm_set1_ps(tile_size.y);
+	auto const half = _mm_set1_ps(0.5f);
+	for (; i + 4u <= num; i += 4u) {
+		auto x = _mm_loadu_ps(world_x + i);
+		auto y = _mm_loadu_ps(world_y + i);
+		// note: multiplying by 0.5 is exact, so results equal the scalar version
+		_mm_storeu_ps(screen_x + i, _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(x, y), tx), half));
+		_mm_storeu_ps(screen_y + i, _mm_mul_ps(_mm_mul_ps(_mm_add_ps(x, y), ty), half));
+	}
+#endif
+	for (; i < num; ++i) {
+		auto pos = toScreen(sf::Vector2f{world_x[i], world_y[i]});
+		screen_x[i] = pos.x;
+		screen_y[i] = pos.y;
+	}
+}
+
+// specialization for orthogonal maps
+template<>
+inline void Tiling<GridMode::Orthogonal>::fromScreen(float const * screen_x, float const * screen_y, float* world_x,
+	float* world_y, std::size_t num) const {
+	std::size_t i{0u};
+#if defined(__SSE2__) || defined(_M_X64)
+	auto const tx = _mm_set1_ps(tile_size.x);
+	auto const ty = _mm_set1_ps(tile_size.y);
+	for (; i + 4u <= num; i += 4u) {
+		auto x = _mm_loadu_ps(screen_x + i);
+		auto y = _mm_loadu_ps(screen_y + i);
+		_mm_storeu_ps(world_x + i, _mm_div_ps(x, tx));
+		_mm_storeu_ps(world_y + i, _mm_div_ps(y, ty));
+	}
+#endif
+	for (; i < num; ++i) {
+		auto pos = fromScreen(sf::Vector2f{screen_x[i], screen_y[i]});
+		world_x[i] = pos.x;
+		world_y[i] = pos.y;
+	}
+}
+
+// specialization for isometric (diamond) maps
+template<>
+inline void Tiling<GridMode::IsoDiamond>::fromScreen(float const * screen_x, float const * screen_y, float* world_x,
+	float* world_y, std::size_t num) const {
+	std::size_t i{0u};
+#if defined(__SSE2__) || defined(_M_X64)
+	auto const hx = _mm_set1_ps(tile_size.x / 2.f);
+	auto const hy = _mm_set1_ps(tile_size.y / 2.f);
+	auto const half = _mm_set1_ps(0.5f);
+	for (; i + 4u <= num; i += 4u) {
+		auto x = _mm_div_ps(_mm_loadu_ps(screen_x + i), hx);
+		auto y = _mm_div_ps(_mm_loadu_ps(screen_y + i), hy);
+		_mm_storeu_ps(world_x + i, _mm_mul_ps(_mm_add_ps(x, y), half));
+		_mm_storeu_ps(world_y + i, _mm_mul_ps(_mm_sub_ps(y, x), half));
+	}
+#endif
+	for (; i < num; ++i) {
+		auto pos = fromScreen(sf::Vector2f{screen_x[i], screen_y[i]});
+		world_x[i] = pos.x;
+		world_y[i] = pos.y;
+	}
+}
+
 // specialization for orthogonal
 template <>
 inline sf::Vector2i Tiling<GridMode::Orthogonal>::getTopleft() const {
@@ -173,17 +367,13 @@ inline sf::Vector2i Tiling<GridMode::Orthogonal>::getTopleft() const {
 // specialization for isometric (diamond) maps
 template <>
 inline sf::Vector2i Tiling<GridMode::IsoDiamond>::getTopleft() const {
-	sf::Vector2i topleft;
-	auto center = fromScreen(view.getCenter());
-	auto range = sf::Vector2i{getRange()};
-	
-	// calculate topleft
-	// x - width : go to topleft corner
-	// x - 2 & y - 2 : because tile might be rendered centered (else: gap at top), vertical zigzag -> x2
-	topleft.x = static_cast<unsigned int>(center.x) - range.x - 2;
-	topleft.y = static_cast<unsigned int>(center.y) - 2;
-	
-	return topleft;
+	int first_row, last_row, left, width;
+	if (!getDiamondBounds(first_row, last_row, left, width)) {
+		return {0, 0};
+	}
+	// start of the first row (row + column is even)
+	auto column = (first_row % 2 == 0) ? left : left - 1;
+	return {(first_row + column) / 2, (first_row - column) / 2};
 }
 
 // specialization for orthogonal maps
@@ -201,16 +391,86 @@ inline sf::Vector2i Tiling<GridMode::Orthogonal>::getBottomleft() const {
 // specialization for isometric (diamond) maps
 template <>
 inline sf::Vector2i Tiling<GridMode::IsoDiamond>::getBottomleft() const {
-	sf::Vector2i bottomleft;
-	auto center = fromScreen(view.getCenter());
-	auto range = sf::Vector2i{getRange()};
-	
-	// calculate topleft
-	// x - width + height / 2 & y + height / 2 : go to bottomleft corner
-	bottomleft.x = static_cast<unsigned int>(center.x) - range.x + range.y / 2;
-	bottomleft.y = static_cast<unsigned int>(center.y) + range.y / 2;
-	
-	return bottomleft;
+	int first_row, last_row, left, width;
+	if (!getDiamondBounds(first_row, last_row, left, width)) {
+		return {0, 0};
+	}
+	// start of the row behind the last one, as reached by the iterator's zigzag
+	auto row = last_row + 1;
+	auto column = (row % 2 == 0) ? left : left - 1;
+	return {(row + column) / 2, (row - column) / 2};
+}
+
+// specialization for orthogonal maps
+template <>
+inline void Tiling<GridMode::Orthogonal>::getSpans(std::vector<TileSpan>& spans) const {
+	// rows are one tile apart
+	scanView(spans, tile_size.y, 0.f);
+}
+
+// specialization for isometric (diamond) maps
+template <>
+inline void Tiling<GridMode::IsoDiamond>::getSpans(std::vector<TileSpan>& spans) const {
+	// rows are half a tile apart and every row is shifted by half a tile to the left
+	scanView(spans, tile_size.y / 2.f, -tile_size.x / 2.f);
+}
+
+// specialization for orthogonal maps
+template <>
+inline sf::Vector2i Tiling<GridMode::Orthogonal>::getTile(TileSpan const & span, int x) {
+	return {x, span.row};
+}
+
+// specialization for isometric (diamond) maps
+template <>
+inline sf::Vector2i Tiling<GridMode::IsoDiamond>::getTile(TileSpan const & span, int x) {
+	return {x, span.row - x};
+}
+
+template <GridMode M>
+void Tiling<M>::subtractSpan(std::vector<TileSpan>& spans, TileSpan const & span, TileSpan const & other) {
+	// part left of the other span
+	auto end = std::min(span.x_end, other.x_begin);
+	if (span.x_begin < end) {
+		spans.push_back({span.row, span.x_begin, end});
+	}
+	// part right of the other span
+	auto begin = std::max(span.x_begin, other.x_end);
+	if (begin < span.x_end) {
+		spans.push_back({span.row, begin, span.x_end});
+	}
+}
+
+template <GridMode M>
+void Tiling<M>::getDelta(sf::View const & previous, std::vector<TileSpan>& entered, std::vector<TileSpan>& left) const {
+	auto other = *this;
+	other.setView(previous);
+	std::vector<TileSpan> previous_spans, current_spans;
+	other.getSpans(previous_spans);
+	getSpans(current_spans);
+	getDelta(previous_spans, current_spans, entered, left);
+}
+
+template <GridMode M>
+void Tiling<M>::getDelta(std::vector<TileSpan> const & previous, std::vector<TileSpan> const & current,
+	std::vector<TileSpan>& entered, std::vector<TileSpan>& left) {
+	entered.clear();
+	left.clear();
+	// merge both lists by row
+	auto i = previous.begin();
+	auto j = current.begin();
+	while (i != previous.end() || j != current.end()) {
+		if (j == current.end() || (i != previous.end() && i->row < j->row)) {
+			left.push_back(*i++);
+		} else if (i == previous.end() || j->row < i->row) {
+			entered.push_back(*j++);
+		} else {
+			subtractSpan(entered, *j, *i);
+			subtractSpan(left, *i, *j);
+			++i;
+			++j;
+		}
+	}
 }
 
 // ---------------------------------------------------------------------------
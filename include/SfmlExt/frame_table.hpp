@@ -0,0 +1,148 @@
+#pragma once
+#include <cstdint>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include <SfmlExt/atlas.hpp>
+
+namespace sfext {
+
+/// Memory layout of a frame table
+enum class FrameTableMode: std::uint32_t {
+	Direct,	// slots are indexed by key - key_base
+	Hashed	// open addressing with linear probing
+};
+
+/// Description of a frame table's slots
+/**
+ * Together with the slots themselves, this is everything necessary to
+ * perform lookups. So a table can be stored in a file (see `AtlasCache`)
+ * and used without building it again.
+ */
+struct FrameTableLayout {
+	FrameTableMode mode;
+	std::uint32_t reserved;		// always zero
+	std::int64_t key_base;		// smallest key (direct mode only)
+	std::uint64_t capacity;		// number of slots (power of two if hashed)
+	std::uint64_t num_frames;	// number of used slots
+};
+
+/// Slot of a frame table
+template <typename Key>
+struct FrameTableEntry {
+	Key key;
+	std::uint32_t used; // nonzero if the slot holds a frame
+	AtlasFrame frame;
+};
+
+/// Convert an integral or enum key to an integer
+/**
+ * @param key to convert
+ * @param [out] value integer representation of the key
+ * @return true if the key is integral or an enum
+ */
+template <typename Key>
+typename std::enable_if<std::is_integral<Key>::value || std::is_enum<Key>::value, bool>::type
+toFrameIndex(Key const & key, std::int64_t& value);
+
+template <typename Key>
+typename std::enable_if<!std::is_integral<Key>::value && !std::is_enum<Key>::value, bool>::type
+toFrameIndex(Key const & key, std::int64_t& value);
+
+// ---------------------------------------------------------------------------
+
+/// Read-only lookup table of atlas frames
+/**
+ * Unlike `std::unordered_map`, all frames are stored inside a single
+ * array, so a lookup does not follow any pointers and usually touches a
+ * single cache line. The table is frozen once it was built.
+ * If the keys are integral (or enums) and dense, i.e. at most every second
+ * key within the keys' range is unused, each key is directly used as index
+ * into the array. Otherwise, the frames are stored in an open addressing
+ * hash table with a load factor of at most 0.5.
+ * The table can either own its slots or refer to external slots (e.g.
+ * inside a memory-mapped cache file), see `attach`. Lookups of attached
+ * tables require `HashFunc` to yield the same values as while building.
+ */
+template <typename Key, typename HashFunc=std::hash<Key>>
+class FrameTable {
+	public:
+		using Entry = FrameTableEntry<Key>;
+
+	private:
+		std::vector<Entry> storage; // owned slots
+		Entry const * external; // attached slots or nullptr
+		FrameTableLayout layout;
+		HashFunc hash;
+
+		/// Get pointer to the first slot
+		Entry const * getSlots() const;
+
+		/// Determine first slot to probe for a key
+		std::size_t getHome(Key const & key) const;
+
+	public:
+		/// Create an empty table
+		FrameTable();
+
+		/// Create a table of the given frames
+		/**
+		 * @param frames to store
+		 */
+		FrameTable(std::unordered_map<Key, AtlasFrame, HashFunc> const & frames);
+
+		/// Build the table of the given frames
+		/**
+		 * Previously stored or attached frames are dropped.
+		 * @param frames to store
+		 */
+		void build(std::unordered_map<Key, AtlasFrame, HashFunc> const & frames);
+
+		/// Use external slots instead of owned ones
+		/**
+		 * The slots are not copied, so they have to outlive the table.
+		 * @param entries pointer to `layout.capacity` slots
+		 * @param layout describing the slots
+		 */
+		void attach(Entry const * entries, FrameTableLayout const & layout);
+
+		/// Lookup a frame
+		/**
+		 * @param key of the frame
+		 * @return pointer to the frame or nullptr if not found
+		 */
+		AtlasFrame const * find(Key const & key) const;
+
+		/// Lookup a frame's slot
+		/**
+		 * The slot's index (relative to `getEntries`) can be used to
+		 * store additional per-frame data next to the table.
+		 * @param key of the frame
+		 * @return pointer to the slot or nullptr if not found
+		 */
+		Entry const * findEntry(Key const & key) const;
+
+		/// Get number of frames
+		/**
+		 * @return number of frames
+		 */
+		std::size_t getNumFrames() const;
+
+		/// Get the table's layout
+		/**
+		 * @return layout of the slots
+		 */
+		FrameTableLayout const & getLayout() const;
+
+		/// Get all slots
+		/**
+		 * Unused slots are zeroed.
+		 * @return pointer to `getLayout().capacity` slots
+		 */
+		Entry const * getEntries() const;
+};
+
+} // ::sfext
+
+// include implementation details
+#include <SfmlExt/details/frame_table.inl>
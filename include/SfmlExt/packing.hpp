@@ -0,0 +1,254 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Graphics/Rect.hpp>
+
+namespace sfext {
+
+/// Supported packing strategies
+enum class PackingMode {
+	Scan, MaxRects, Skyline, Guillotine
+};
+
+/// Base class for rectangle packers
+/**
+ * A packer places rectangles of a given size inside a bin. Each packer
+ * implements a different strategy (see `PackingMode`). The packer only
+ * knows about rectangles, so it can be used independently of any image.
+ */
+class RectPacker {
+	public:
+		virtual ~RectPacker();
+
+		/// Reset the packer to an empty bin
+		/**
+		 * @param size of the bin
+		 */
+		virtual void reset(sf::Vector2u const & size) = 0;
+
+		/// Try to place a rectangle
+		/**
+		 * If no free space was found, the packer's state is not changed.
+		 * If `rotated` is given, the packer may also place the rectangle
+		 * rotated by 90° (i.e. with swapped width and height) if that fits
+		 * better according to its heuristic.
+		 * @param size of the rectangle to place
+		 * @param [out] pos topleft position of the placed rectangle
+		 * @param [out] rotated set to true if the rectangle was rotated (nullptr to disallow rotation)
+		 * @return true if the rectangle was placed
+		 */
+		virtual bool insert(sf::Vector2i const & size, sf::Vector2i& pos, bool* rotated=nullptr) = 0;
+
+		/// Enlarge the bin without moving placed rectangles
+		/**
+		 * The new area to the right and to the bottom is added as free
+		 * space. This allows to continue packing into a larger bin instead
+		 * of packing all rectangles from scratch.
+		 * @param size of the bin, not smaller than the current size
+		 */
+		virtual void grow(sf::Vector2u const & size) = 0;
+
+		/// Create a copy of the packer including its current state
+		/**
+		 * This can be used to try multiple placements without modifying
+		 * the original packer.
+		 * @return uniquely owned copy
+		 */
+		virtual std::unique_ptr<RectPacker> clone() const = 0;
+};
+
+// ---------------------------------------------------------------------------
+
+/// Spatial index of placed rectangles
+/**
+ * The bin is divided into a coarse grid of cells. Each cell knows which
+ * placed rectangles overlap it, so a collision query only tests rectangles
+ * near the queried area instead of all placed rectangles.
+ */
+class OccupancyGrid {
+	private:
+		int cell_size;
+		sf::Vector2i num_cells;
+		std::vector<sf::IntRect> rects;					// placed rectangles
+		std::vector<std::vector<std::size_t>> cells;	// indices per cell
+
+	public:
+		/// Create a new occupancy grid
+		/**
+		 * @param cell_size number of pixels per cell's dimension
+		 */
+		OccupancyGrid(int cell_size=32);
+
+		/// Reset the grid to an empty bin
+		/**
+		 * @param size of the bin
+		 */
+		void reset(sf::Vector2u const & size);
+
+		/// Resize the grid while keeping all placed rectangles
+		/**
+		 * @param size of the bin
+		 */
+		void resize(sf::Vector2u const & size);
+
+		/// Mark a rectangle as occupied
+		/**
+		 * @param rect to add
+		 */
+		void add(sf::IntRect const & rect);
+
+		/// Query a placed rectangle which collides with the given one
+		/**
+		 * @param rect to test
+		 * @return pointer to colliding rectangle or nullptr if free
+		 */
+		sf::IntRect const * findCollision(sf::IntRect const & rect) const;
+
+		/// Check whether nothing was placed yet
+		/**
+		 * @return true if empty
+		 */
+		bool isEmpty() const;
+};
+
+// ---------------------------------------------------------------------------
+
+/// Reference packer scanning a step grid for a free position
+/**
+ * Each position on a grid is tested row by row. The grid's step range is
+ * reduced to the gcd of all placed rectangles' sizes, but never below
+ * `min_step`. This is slow but was the original atlas implementation.
+ */
+class ScanPacker: public RectPacker {
+	private:
+		sf::Vector2u min_step;
+		sf::Vector2i size, step_range;
+		OccupancyGrid used;	// placed rectangles
+
+		/// Search the first free position of a rectangle
+		bool find(sf::Vector2i const & size, sf::Vector2i& pos) const;
+
+	public:
+		/// Create a new scan packer
+		/**
+		 * @param min_step determines the minimum step range
+		 */
+		ScanPacker(sf::Vector2u const & min_step);
+
+		void reset(sf::Vector2u const & size) override;
+		bool insert(sf::Vector2i const & size, sf::Vector2i& pos, bool* rotated=nullptr) override;
+		void grow(sf::Vector2u const & size) override;
+		std::unique_ptr<RectPacker> clone() const override;
+};
+
+/// MaxRects packer using the best-short-side-fit heuristic
+/**
+ * All maximal free rectangles are tracked. A rectangle is placed into the
+ * free rectangle which leaves the shortest leftover side.
+ */
+class MaxRectsPacker: public RectPacker {
+	private:
+		sf::Vector2i size;
+		std::vector<sf::IntRect> free_rects;	// maximal free rectangles
+
+		/// Split all free rectangles overlapped by the placed rectangle
+		/**
+		 * @return index of the first new free rectangle
+		 */
+		std::size_t split(sf::IntRect const & placed);
+
+		/// Remove free rectangles contained in others
+		/**
+		 * @param first index of the first rectangle which might be contained
+		 */
+		void prune(std::size_t first=0u);
+
+	public:
+		MaxRectsPacker();
+
+		void reset(sf::Vector2u const & size) override;
+		bool insert(sf::Vector2i const & size, sf::Vector2i& pos, bool* rotated=nullptr) override;
+		void grow(sf::Vector2u const & size) override;
+		std::unique_ptr<RectPacker> clone() const override;
+
+		/// Mark a rectangle at a fixed position as used
+		/**
+		 * @param rect to mark as used
+		 */
+		void occupy(sf::IntRect const & rect);
+
+		/// Mark a previously used rectangle as free
+		/**
+		 * The rectangle is added as another free rectangle. It is not
+		 * merged with neighbouring free space, so large rectangles might
+		 * not fit afterwards although enough space is free. Use `reset`
+		 * and `occupy` to rebuild the maximal free rectangles.
+		 * @param rect to mark as free
+		 */
+		void release(sf::IntRect const & rect);
+};
+
+/// Skyline packer using the bottom-left heuristic
+/**
+ * Only the upper contour of all placed rectangles is tracked. A rectangle
+ * is placed at the skyline position where its bottom edge is lowest.
+ */
+class SkylinePacker: public RectPacker {
+	private:
+		/// Horizontal segment of the skyline
+		struct Node {
+			int x, y, width;
+		};
+
+		sf::Vector2i size;
+		std::vector<Node> nodes;	// skyline from left to right
+
+		/// Determine the top position of a rectangle placed at a node
+		/**
+		 * @return top position or -1 if it does not fit there
+		 */
+		int fit(std::size_t index, sf::Vector2i const & size) const;
+
+	public:
+		SkylinePacker();
+
+		void reset(sf::Vector2u const & size) override;
+		bool insert(sf::Vector2i const & size, sf::Vector2i& pos, bool* rotated=nullptr) override;
+		void grow(sf::Vector2u const & size) override;
+		std::unique_ptr<RectPacker> clone() const override;
+};
+
+/// Guillotine packer using best-area-fit and shorter-leftover-axis split
+/**
+ * Free space is tracked as disjoint rectangles. Each placement cuts its
+ * free rectangle into two along the shorter leftover axis.
+ */
+class GuillotinePacker: public RectPacker {
+	private:
+		sf::Vector2i size;
+		std::vector<sf::IntRect> free_rects;	// disjoint free rectangles
+
+		/// Merge a free rectangle with others which share an entire edge
+		void merge(std::size_t index);
+
+	public:
+		GuillotinePacker();
+
+		void reset(sf::Vector2u const & size) override;
+		bool insert(sf::Vector2i const & size, sf::Vector2i& pos, bool* rotated=nullptr) override;
+		void grow(sf::Vector2u const & size) override;
+		std::unique_ptr<RectPacker> clone() const override;
+};
+
+// ---------------------------------------------------------------------------
+
+/// Create a packer for the given mode
+/**
+ * @param mode determines the packing strategy
+ * @param min_step used by `PackingMode::Scan` only
+ * @return uniquely owned packer
+ */
+std::unique_ptr<RectPacker> createPacker(PackingMode mode, sf::Vector2u const & min_step);
+
+} // ::sfext
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+
+namespace sfext {
+
+/// Determine the number of worker threads to use
+/**
+ * @param num_threads requested number of threads, 0 for all hardware threads
+ * @return number of threads (at least 1)
+ */
+std::size_t getNumThreads(std::size_t num_threads);
+
+/// Invoke a function for each index using a pool of worker threads
+/**
+ * The indices [0, num_items) are handed out dynamically to `num_threads`
+ * threads (including the calling thread), so the order of invocation is
+ * unspecified. The call returns after all indices were processed. If a
+ * function call throws, the first exception is rethrown afterwards.
+ * @param num_items number of indices to process
+ * @param num_threads number of threads, 0 for all hardware threads
+ * @param func callable with signature `void(std::size_t index)`
+ */
+template <typename Func>
+void parallelFor(std::size_t num_items, std::size_t num_threads, Func func);
+
+} // ::sfext
+
+// include implementation details
+#include <SfmlExt/details/parallel.inl>
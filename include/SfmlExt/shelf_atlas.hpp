@@ -0,0 +1,149 @@
+#pragma once
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <SFML/Graphics/Texture.hpp>
+#include <SfmlExt/atlas.hpp>
+
+namespace sfext {
+
+/// Usage statistics of a shelf atlas
+struct ShelfAtlasStats {
+	std::size_t hits;		// successful lookups
+	std::size_t misses;		// lookups of missing frames
+	std::size_t insertions;	// inserted frames
+	std::size_t evictions;	// frames evicted to make room for others
+};
+
+/// Fixed-size atlas for short-lived images created at runtime
+/**
+ * Frames are placed on horizontal shelves: Each shelf has a fixed height
+ * and frames are placed side by side. Frames are only put onto shelves
+ * which are not much higher than the frame itself. If no space is left,
+ * the least recently used frames (see `find`) are evicted until the new
+ * frame fits. This is meant as a cache for images like name tags or
+ * damage numbers, which would otherwise need a texture each.
+ * All modified rows are tracked, so only those rows need to be uploaded
+ * to the texture (see `update`).
+ */
+template <typename Key, typename HashFunc=std::hash<Key>>
+class ShelfAtlas {
+	private:
+		/// Horizontal strip of the atlas
+		struct Shelf {
+			int top, height;
+			std::vector<sf::Vector2i> spans; // free (x, width) sorted by x
+		};
+
+		/// Frame and its position inside the LRU list
+		struct Entry {
+			AtlasFrame frame;
+			typename std::list<Key>::iterator lru;
+		};
+
+		sf::Image image;
+		std::unordered_map<Key, Entry, HashFunc> entries;
+		std::list<Key> lru;			// most recently used first
+		std::vector<Shelf> shelves;	// sorted by top
+		int bottom;					// bottom of the last shelf
+		int dirty_top, dirty_bottom;	// modified rows since last `clearDirty`
+		ShelfAtlasStats stats;
+
+		/// Determine index of the shelf at the given top
+		std::size_t getShelf(int top) const;
+
+		/// Try to allocate space on the shelves
+		/**
+		 * @param size of the frame
+		 * @param [out] slot allocated area (frame's width, shelf's height)
+		 * @return true if space was found
+		 */
+		bool allocate(sf::Vector2i const & size, sf::IntRect& slot);
+
+		/// Free the space of a frame
+		void release(sf::IntRect const & rect);
+
+		/// Evict the least recently used frame
+		bool evict();
+
+	public:
+		/// Create an empty atlas
+		/**
+		 * @param size of the atlas image
+		 */
+		ShelfAtlas(sf::Vector2u const & size);
+
+		/// Lookup a frame and mark it as recently used
+		/**
+		 * @param key of the frame
+		 * @return pointer to the frame or nullptr if it was not found (e.g. evicted)
+		 */
+		AtlasFrame const * find(Key const & key);
+
+		/// Insert a frame
+		/**
+		 * The image is shrinked to its minimum size (see
+		 * `AtlasGenerator::add`). If a frame with that key already exists,
+		 * it is replaced, unless the new frame exceeds the atlas. Least
+		 * recently used frames are evicted until the frame fits. If the
+		 * frame is lower than its shelf, the pixels below it are cleared.
+		 * @param key used to identify the image
+		 * @param image to copy into the atlas
+		 * @param origin for the original image
+		 * @return pointer to the frame or nullptr if it exceeds the atlas
+		 */
+		AtlasFrame const * insert(Key const & key, sf::Image const & image, sf::Vector2f origin);
+
+		/// Erase a frame
+		/**
+		 * @param key of the frame to erase
+		 * @return true if the frame existed
+		 */
+		bool erase(Key const & key);
+
+		/// Erase all frames
+		void clear();
+
+		/// Get number of frames
+		/**
+		 * @return number of frames
+		 */
+		std::size_t getNumFrames() const;
+
+		/// Get the atlas image
+		/**
+		 * @return const reference to the image
+		 */
+		sf::Image const & getImage() const;
+
+		/// Get the rows which were modified since last `clearDirty`
+		/**
+		 * @return full-width rectangle of all dirty rows (empty if nothing was modified)
+		 */
+		sf::IntRect getDirtyRect() const;
+
+		/// Reset the dirty rows after uploading them
+		void clearDirty();
+
+		/// Upload dirty rows to a texture and reset them
+		/**
+		 * The rows are uploaded directly from the atlas image. The texture
+		 * must have the size of the atlas.
+		 * @param texture to update
+		 */
+		void update(sf::Texture& texture);
+
+		/// Get usage statistics
+		/**
+		 * @return statistics since creation or last `resetStats`
+		 */
+		ShelfAtlasStats const & getStats() const;
+
+		/// Reset usage statistics
+		void resetStats();
+};
+
+} // ::sfext
+
+// include implementation details
+#include <SfmlExt/details/shelf_atlas.inl>
@@ -0,0 +1,106 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <SfmlExt/frame_table.hpp>
+#include <SfmlExt/tiling.hpp>
+
+namespace sfext {
+
+/// Vertex arrays of all visible tiles
+/**
+ * All visible tiles of a `Tiling` are turned into one `sf::VertexArray`
+ * of quads per layer and atlas page, so each layer is rendered by a
+ * single draw call per page using the page's texture. Each tile refers to
+ * an atlas frame by its key; the quad is placed at the tile's screen
+ * position minus the frame's origin. Rotated frames are supported (see
+ * `getTexCoords`). Within a layer, tiles are only drawn in rendering
+ * order if they are on the same page, so tiles which overlap on screen
+ * should be grouped onto one page (see `AtlasGenerator::generatePages`).
+ * The visible tiles are determined by `Tiling::getSpans`, so rotated or
+ * zoomed views do not produce quads for invisible tiles. The vertices are
+ * only rebuilt if the visible tiles change, i.e. the view crosses a tile
+ * boundary, or if the data was invalidated. Building the vertices is pure
+ * CPU work, so no window is required.
+ */
+template <typename Key, GridMode M, typename HashFunc=std::hash<Key>>
+class TileBatch {
+	public:
+		/// Determines the frame of a tile in a layer
+		/**
+		 * The function returns false if the tile is empty in that layer.
+		 * It is also invoked for positions outside the map (which should
+		 * be reported as empty). Positions left or above the map wrap
+		 * around to huge values.
+		 */
+		using TileFunc = std::function<bool(sf::Vector2u const & pos, std::size_t layer, Key& key)>;
+
+	private:
+		FrameTable<Key, HashFunc> const & frames;
+		TileFunc tiles;
+		std::vector<std::vector<sf::VertexArray>> layers; // per layer and page
+		std::vector<TileSpan> spans;	// visible tiles of the last rebuild
+		std::vector<TileSpan> current;	// visible tiles of the current update
+		sf::Vector2f tile_size;
+		bool dirty;				// true if the vertices need to be rebuilt
+		std::size_t num_rebuilds;
+
+		/// Rebuild the vertices of all layers from the visible spans
+		void rebuild(Tiling<M> const & tiling);
+
+	public:
+		/// Create a new batch
+		/**
+		 * The frame table is not copied, so it has to outlive the batch.
+		 * @param frames atlas frames referred to by the tiles
+		 * @param num_layers number of layers
+		 * @param tiles determines the frame of a tile in a layer
+		 */
+		TileBatch(FrameTable<Key, HashFunc> const & frames, std::size_t num_layers, TileFunc tiles);
+
+		/// Force rebuilding the vertices on next update
+		/**
+		 * This has to be called whenever tiles or frames are modified.
+		 */
+		void invalidate();
+
+		/// Rebuild the vertices if necessary
+		/**
+		 * The visible spans are determined on every call, which is cheap
+		 * compared to rebuilding the vertices.
+		 * @param tiling providing the visible tile positions
+		 * @return true if the vertices were rebuilt
+		 */
+		bool update(Tiling<M> const & tiling);
+
+		/// Get number of layers
+		/**
+		 * @return number of layers
+		 */
+		std::size_t getNumLayers() const;
+
+		/// Get number of atlas pages referred to by the tiles
+		/**
+		 * @return number of pages (at least one)
+		 */
+		std::size_t getNumPages() const;
+		
+		/// Get the vertices of a layer
+		/**
+		 * @param layer index of the layer
+		 * @param page index of the atlas page (less than `getNumPages`)
+		 * @return quads of all visible tiles on that page in rendering order
+		 */
+		sf::VertexArray const & getLayer(std::size_t layer, std::size_t page=0u) const;
+
+		/// Get number of rebuilds
+		/**
+		 * @return number of rebuilds since creation
+		 */
+		std::size_t getNumRebuilds() const;
+};
+
+} // ::sfext
+
+// include implementation details
+#include <SfmlExt/details/tile_batch.inl>
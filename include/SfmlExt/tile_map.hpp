@@ -0,0 +1,184 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <SfmlExt/tiling.hpp>
+
+namespace sfext {
+
+/// Used for iteration over a tile map's visible tiles
+/**
+ * The iterator walks the tile positions of a `TilingIterator` and skips
+ * all positions outside the map. Dereferencing yields a reference to the
+ * tile itself.
+ */
+template <typename Map>
+class TileMapIterator {
+	private:
+		Map* map;
+		TilingIterator<Map::mode> current, last;
+
+		/// Skip positions outside the map
+		void skip();
+
+	public:
+		/// Create a new iterator
+		/**
+		 * @param map to iterate over
+		 * @param current tiling iterator at the first position
+		 * @param last tiling iterator at the first position out of range
+		 */
+		TileMapIterator(Map& map, TilingIterator<Map::mode> const & current, TilingIterator<Map::mode> const & last);
+
+		/// Returns the current tile
+		/**
+		 * @return reference to the tile
+		 */
+		auto operator*() const -> decltype(std::declval<Map&>()[sf::Vector2u{}]);
+
+		/// Used to compare two iterators
+		/**
+		 * @param other Iterator to compare with
+		 * @return true if positions do not equal
+		 */
+		bool operator!=(TileMapIterator<Map> const & other) const;
+
+		/// Step to next position inside the map
+		void operator++();
+
+		/// Returns the current tile position
+		/**
+		 * @return Tile position which the iterator is indicating at
+		 */
+		sf::Vector2u getPosition() const;
+};
+
+/// Range of a tile map's visible tiles (see `TileMap::getVisible`)
+template <typename Map>
+class TileMapRange {
+	private:
+		Map* map;
+		TilingIterator<Map::mode> first, last;
+
+	public:
+		/// Create a new range
+		/**
+		 * @param map to iterate over
+		 * @param tiling providing the visible tile positions
+		 */
+		TileMapRange(Map& map, Tiling<Map::mode> const & tiling);
+
+		/// Returns iterator to first visible tile
+		TileMapIterator<Map> begin() const;
+
+		/// Returns iterator behind the last visible tile
+		TileMapIterator<Map> end() const;
+};
+
+/// Rectangular map of tiles stored in chunks
+/**
+ * Tiles are stored in square chunks of `chunk_size` x `chunk_size` tiles.
+ * Inside each chunk, tiles are stored in Z-order (Morton order), so tiles
+ * which are close to each other in any direction are also close to each
+ * other in memory. Unlike row-major storage, traversing the map along
+ * screen rows of an isometric diamond grid stays inside a few cache lines
+ * per chunk.
+ * The visible tiles can be iterated directly (see `getVisible`), so
+ * there is no need to index the map with the positions yielded by a
+ * `Tiling`.
+ */
+template <typename T, GridMode M>
+class TileMap {
+	public:
+		static GridMode const mode = M;
+		static unsigned int const chunk_bits = 5u;
+		static unsigned int const chunk_size = 1u << chunk_bits; // tiles per chunk dimension
+
+	private:
+		sf::Vector2u size;
+		unsigned int num_chunks_x; // chunks per row
+		std::vector<T> tiles; // chunk by chunk (row by row), Morton order inside
+		std::uint32_t spread[1u << chunk_bits]; // bits of local coordinates spread to even bits
+
+		/// Spread the lower 16 bits of a value to the even bits
+		static std::uint32_t spreadBits(std::uint32_t value);
+
+		/// Determine storage index of a tile
+		std::size_t getIndex(sf::Vector2u const & pos) const;
+
+	public:
+		/// Create a new tile map
+		/**
+		 * @param size number of tiles per map dimension
+		 * @param value used to initialize all tiles
+		 */
+		TileMap(sf::Vector2u const & size, T const & value=T{});
+
+		/// Get the map size
+		/**
+		 * @return number of tiles per map dimension
+		 */
+		sf::Vector2u getSize() const;
+
+		/// Test whether a position is inside the map
+		/**
+		 * @param pos tile position to test
+		 * @return true if the position is inside the map
+		 */
+		bool contains(sf::Vector2u const & pos) const;
+
+		/// Access a tile without bounds checking
+		/**
+		 * @param pos tile position (must be inside the map)
+		 * @return reference to the tile
+		 */
+		T& operator[](sf::Vector2u const & pos);
+
+		/// Access a tile without bounds checking
+		/**
+		 * @param pos tile position (must be inside the map)
+		 * @return const reference to the tile
+		 */
+		T const & operator[](sf::Vector2u const & pos) const;
+
+		/// Access a tile
+		/**
+		 * @throw std::out_of_range if the position is outside the map
+		 * @param pos tile position
+		 * @return reference to the tile
+		 */
+		T& at(sf::Vector2u const & pos);
+
+		/// Access a tile
+		/**
+		 * @throw std::out_of_range if the position is outside the map
+		 * @param pos tile position
+		 * @return const reference to the tile
+		 */
+		T const & at(sf::Vector2u const & pos) const;
+
+		/// Get the visible tiles
+		/**
+		 * The range yields references to all tiles inside the map which
+		 * are visited by iterating the tiling, in the same order. Like
+		 * the tiling's iteration, it covers the bounding box of a rotated
+		 * view, so some of the tiles are invisible. To visit only the
+		 * visible tiles, use `Tiling::getSpans` together with `contains`
+		 * and `operator[]`.
+		 * @param tiling providing the visible tile positions
+		 * @return range of visible tiles
+		 */
+		TileMapRange<TileMap<T, M>> getVisible(Tiling<M> const & tiling);
+
+		/// Get the visible tiles
+		/**
+		 * @param tiling providing the visible tile positions
+		 * @return range of visible tiles
+		 */
+		TileMapRange<TileMap<T, M> const> getVisible(Tiling<M> const & tiling) const;
+};
+
+} // ::sfext
+
+// include implementation details
+#include <SfmlExt/details/tile_map.inl>
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <vector>
 #include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/View.hpp>
@@ -11,6 +12,18 @@ enum class GridMode {
 	// later: IsoStaggered, Hexagonal
 };
 
+/// Run of tiles which are adjacent within a screen row
+/**
+ * For orthogonal grids, the span covers tiles (x, row) for all x in
+ * [x_begin, x_end). For isometric diamond grids, `row` is the screen row
+ * x + y and the span covers tiles (x, row - x) for all x in
+ * [x_begin, x_end), i.e. from left to right on screen.
+ * See `Tiling::getTile` to obtain a span's tile positions.
+ */
+struct TileSpan {
+	int row, x_begin, x_end;
+};
+
 /// Used for iteration over visible area
 template <GridMode M>
 class TilingIterator {
@@ -72,6 +85,40 @@ class Tiling {
 		/// Padding used for iteration
 		sf::Vector2u padding;
 		
+		/// Determine the corners of the (rotated) view in screen space
+		void getViewCorners(sf::Vector2f corners[4]) const;
+		
+		/// Determine the size of the (rotated) view's bounding box
+		sf::Vector2f getViewExtent() const;
+		
+		/// Scan-convert the view into spans
+		/**
+		 * @param [out] spans visible spans
+		 * @param row_step vertical screen distance between rows
+		 * @param shift horizontal screen offset of the tiles per row
+		 */
+		void scanView(std::vector<TileSpan>& spans, float row_step, float shift) const;
+		
+		/// Append the parts of a span which are not covered by another span
+		/**
+		 * @param [out] spans to append to
+		 * @param span to subtract from
+		 * @param other span to subtract (same row)
+		 */
+		static void subtractSpan(std::vector<TileSpan>& spans, TileSpan const & span, TileSpan const & other);
+		
+		/// Determine the zigzag iteration bounds of the visible tiles (iso diamond only)
+		/**
+		 * Screen columns are x - y, screen rows are x + y. Rows of even
+		 * parity start at column `left`, rows of odd parity at `left - 1`.
+		 * @param [out] first_row first visible screen row
+		 * @param [out] last_row last visible screen row
+		 * @param [out] left even start column of the rows
+		 * @param [out] width number of tiles per row minus one
+		 * @return false if no tile is visible
+		 */
+		bool getDiamondBounds(int& first_row, int& last_row, int& left, int& width) const;
+		
 	public:
 		/// Create a new tiling for a fixed map size and tile size
 		/**
@@ -125,6 +172,9 @@ class Tiling {
 		
 		/// Determine number of tiles without iterating them
 		/**
+		 * The range covers the bounding box of the view (including the
+		 * padding), so rotated views are covered entirely. Use `getSpans`
+		 * to visit only the visible tiles of a rotated view.
 		 * @return number of tiles per dimension
 		 */
 		sf::Vector2u getRange() const;
@@ -151,6 +201,86 @@ class Tiling {
 		 */
 		sf::Vector2f fromScreen(sf::Vector2f const & screen_pos) const;
 		
+		/// Converts multiple world positions to screen positions
+		/**
+		 * Works like `toScreen` but for arrays of coordinates (structure
+		 * of arrays). If available, SSE2 is used to convert four positions
+		 * at once; the results equal those of `toScreen`. The output may
+		 * alias the input.
+		 * @param world_x x-coordinates of world positions
+		 * @param world_y y-coordinates of world positions
+		 * @param [out] screen_x x-coordinates of screen positions
+		 * @param [out] screen_y y-coordinates of screen positions
+		 * @param num number of positions
+		 */
+		void toScreen(float const * world_x, float const * world_y, float* screen_x, float* screen_y,
+			std::size_t num) const;
+		
+		/// Converts multiple screen positions to world positions
+		/**
+		 * Works like `fromScreen` but for arrays of coordinates (structure
+		 * of arrays). If available, SSE2 is used to convert four positions
+		 * at once; the results equal those of `fromScreen`. The output may
+		 * alias the input.
+		 * @param screen_x x-coordinates of screen positions
+		 * @param screen_y y-coordinates of screen positions
+		 * @param [out] world_x x-coordinates of world positions
+		 * @param [out] world_y y-coordinates of world positions
+		 * @param num number of positions
+		 */
+		void fromScreen(float const * screen_x, float const * screen_y, float* world_x, float* world_y,
+			std::size_t num) const;
+		
+		/// Determine visible tiles as spans
+		/**
+		 * The view's actual (rotated and zoomed) rectangle is
+		 * scan-converted row by row. A tile is considered visible if its
+		 * screen bounding box, centered at its screen position and
+		 * enlarged by the padding, overlaps the view. So unlike iterating
+		 * the tiling (see `begin` and `end`), which covers the view's
+		 * bounding box, no invisible tiles are visited. The spans are
+		 * sorted by row, so they are in rendering order. Each screen row
+		 * yields at most one span, so the tiles can be processed without
+		 * stepping through them one by one.
+		 * @param [out] spans visible spans (previous content is cleared)
+		 */
+		void getSpans(std::vector<TileSpan>& spans) const;
+		
+		/// Determine a tile position inside a span
+		/**
+		 * @param span to query
+		 * @param x index inside [span.x_begin, span.x_end)
+		 * @return tile position
+		 */
+		static sf::Vector2i getTile(TileSpan const & span, int x);
+		
+		/// Determine tiles which entered or left the view
+		/**
+		 * The spans of the given previous view are compared with the
+		 * spans of the current view (see `getSpans`) row by row. Only the
+		 * differences are reported, so the result is proportional to the
+		 * views' perimeters rather than their areas. Both lists are sorted
+		 * by row, each row yields at most two spans per list.
+		 * @param previous view to compare the current view with
+		 * @param [out] entered spans which became visible (previous content is cleared)
+		 * @param [out] left spans which are no longer visible (previous content is cleared)
+		 */
+		void getDelta(sf::View const & previous, std::vector<TileSpan>& entered, std::vector<TileSpan>& left) const;
+		
+		/// Determine the difference of two sets of spans
+		/**
+		 * This can be used to avoid recomputing the previous spans if
+		 * they are kept from the last frame. Both inputs have to be
+		 * sorted by row with at most one span per row, as provided by
+		 * `getSpans`.
+		 * @param previous spans of the previous view
+		 * @param current spans of the current view
+		 * @param [out] entered spans only contained in current (previous content is cleared)
+		 * @param [out] left spans only contained in previous (previous content is cleared)
+		 */
+		static void getDelta(std::vector<TileSpan> const & previous, std::vector<TileSpan> const & current,
+			std::vector<TileSpan>& entered, std::vector<TileSpan>& left);
+		
 		/// Calculate topleft position
 		/**
 		 * The position of the topleft tile is returned. This can be used as
@@ -0,0 +1,610 @@
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SFEXT_SSE2
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#include <SfmlExt/atlas.hpp>
+#include <SfmlExt/parallel.hpp>
+
+namespace sfext {
+
+namespace {
+
+/// Determine first non-transparent pixel of a row
+/**
+ * @return index of the pixel or `width` if all pixels are transparent
+ */
+int findFirstOpaque(sf::Uint8 const * row, int width) {
+	int x{0};
+#if defined(__AVX2__)
+	// test 8 pixels at once
+	auto const alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+	auto const zero = _mm256_setzero_si256();
+	for (; x + 8 <= width; x += 8) {
+		auto pixels = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(row + 4 * x));
+		auto empty = _mm256_cmpeq_epi32(_mm256_and_si256(pixels, alpha), zero);
+		if (_mm256_movemask_epi8(empty) != -1) {
+			break;
+		}
+	}
+#elif defined(SFEXT_SSE2)
+	// test 4 pixels at once
+	auto const alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+	auto const zero = _mm_setzero_si128();
+	for (; x + 4 <= width; x += 4) {
+		auto pixels = _mm_loadu_si128(reinterpret_cast<__m128i const *>(row + 4 * x));
+		auto empty = _mm_cmpeq_epi32(_mm_and_si128(pixels, alpha), zero);
+		if (_mm_movemask_epi8(empty) != 0xFFFF) {
+			break;
+		}
+	}
+#endif
+	// scalar search (remaining pixels or the block containing the hit)
+	for (; x < width; ++x) {
+		if (row[4 * x + 3] > 0) {
+			break;
+		}
+	}
+	return x;
+}
+
+/// Determine last non-transparent pixel of a row within [begin, width)
+/**
+ * @return index of the pixel or `begin - 1` if all pixels are transparent
+ */
+int findLastOpaque(sf::Uint8 const * row, int begin, int width) {
+	int x{width};
+#if defined(__AVX2__)
+	auto const alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+	auto const zero = _mm256_setzero_si256();
+	for (; x - 8 >= begin; x -= 8) {
+		auto pixels = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(row + 4 * (x - 8)));
+		auto empty = _mm256_cmpeq_epi32(_mm256_and_si256(pixels, alpha), zero);
+		if (_mm256_movemask_epi8(empty) != -1) {
+			break;
+		}
+	}
+#elif defined(SFEXT_SSE2)
+	auto const alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+	auto const zero = _mm_setzero_si128();
+	for (; x - 4 >= begin; x -= 4) {
+		auto pixels = _mm_loadu_si128(reinterpret_cast<__m128i const *>(row + 4 * (x - 4)));
+		auto empty = _mm_cmpeq_epi32(_mm_and_si128(pixels, alpha), zero);
+		if (_mm_movemask_epi8(empty) != 0xFFFF) {
+			break;
+		}
+	}
+#endif
+	for (--x; x >= begin; --x) {
+		if (row[4 * x + 3] > 0) {
+			break;
+		}
+	}
+	return x;
+}
+
+/// Check whether a name matches a wildcard pattern
+bool matchWildcard(char const * pattern, char const * name) {
+	// remember last '*' to backtrack to
+	char const * star{nullptr};
+	char const * resume{nullptr};
+	while (*name != '\0') {
+		if (*pattern == '*') {
+			star = pattern++;
+			resume = name;
+		} else if (*pattern == '?' || *pattern == *name) {
+			++pattern;
+			++name;
+		} else if (star != nullptr) {
+			pattern = star + 1;
+			name = ++resume;
+		} else {
+			return false;
+		}
+	}
+	while (*pattern == '*') {
+		++pattern;
+	}
+	return *pattern == '\0';
+}
+
+/// Cross product of (a - o) and (b - o)
+template <typename T>
+T cross(sf::Vector2<T> const & o, sf::Vector2<T> const & a, sf::Vector2<T> const & b) {
+	return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+/// Remove the polygon edge whose removal adds the least area
+/**
+ * The edge's neighbouring edges are extended until they meet. Edges are
+ * only removed if that point lies inside the given size.
+ * @return false if no edge can be removed
+ */
+bool removeCheapestEdge(std::vector<sf::Vector2<double>>& polygon, sf::Vector2<double> const & size) {
+	auto const n = polygon.size();
+	auto best_area = std::numeric_limits<double>::max();
+	std::size_t best_index{n};
+	sf::Vector2<double> best_point;
+	for (std::size_t i = 0u; i < n; ++i) {
+		auto const & prev = polygon[(i + n - 1u) % n];
+		auto const & a = polygon[i];
+		auto const & b = polygon[(i + 1u) % n];
+		auto const & next = polygon[(i + 2u) % n];
+		// intersect a + t * (a - prev) with b + s * (b - next)
+		auto d1 = a - prev;
+		auto d2 = b - next;
+		auto denom = d1.x * d2.y - d1.y * d2.x;
+		if (std::abs(denom) < 1e-9) {
+			continue;
+		}
+		auto diff = b - a;
+		auto t = (diff.x * d2.y - diff.y * d2.x) / denom;
+		if (t <= 0.0) {
+			// neighbouring edges diverge
+			continue;
+		}
+		sf::Vector2<double> p{a.x + t * d1.x, a.y + t * d1.y};
+		if (p.x < -1e-9 || p.y < -1e-9 || p.x > size.x + 1e-9 || p.y > size.y + 1e-9) {
+			continue;
+		}
+		auto area = std::abs(cross(a, b, p)) / 2.0;
+		if (area < best_area) {
+			best_area = area;
+			best_index = i;
+			best_point = p;
+		}
+	}
+	if (best_index == n) {
+		return false;
+	}
+	polygon[best_index] = best_point;
+	polygon.erase(polygon.begin() + (best_index + 1u) % n);
+	return true;
+}
+
+/// Downsample two rows using a 2x2 box filter
+/**
+ * Pixel `x` of the output is the average of pixels `2x` and `2x+1` of both
+ * rows (clamped to the source width).
+ */
+void downsampleRows(sf::Uint8 const * row0, sf::Uint8 const * row1, unsigned int src_width, sf::Uint8* out,
+	unsigned int width) {
+	unsigned int x{0u};
+#if defined(__AVX2__) || defined(SFEXT_SSE2)
+	if (src_width >= 2u) {
+		// filter 4 output pixels at once using 16-bit sums
+		auto const zero = _mm_setzero_si128();
+		auto const round = _mm_set1_epi16(2);
+		for (; x + 4u <= width; x += 4u) {
+			auto a0 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(row0 + 8u * x));
+			auto a1 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(row0 + 8u * x + 16u));
+			auto b0 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(row1 + 8u * x));
+			auto b1 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(row1 + 8u * x + 16u));
+			// vertical sums of 2 pixels per register
+			auto v0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+			auto v1 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+			auto v2 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+			auto v3 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+			// horizontal sums of neighbouring pixels
+			auto h0 = _mm_unpacklo_epi64(_mm_add_epi16(v0, _mm_srli_si128(v0, 8)), _mm_add_epi16(v1, _mm_srli_si128(v1, 8)));
+			auto h1 = _mm_unpacklo_epi64(_mm_add_epi16(v2, _mm_srli_si128(v2, 8)), _mm_add_epi16(v3, _mm_srli_si128(v3, 8)));
+			h0 = _mm_srli_epi16(_mm_add_epi16(h0, round), 2);
+			h1 = _mm_srli_epi16(_mm_add_epi16(h1, round), 2);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4u * x), _mm_packus_epi16(h0, h1));
+		}
+	}
+#endif
+	for (; x < width; ++x) {
+		auto left = 4u * std::min(2u * x, src_width - 1u);
+		auto right = 4u * std::min(2u * x + 1u, src_width - 1u);
+		for (auto c = 0u; c < 4u; ++c) {
+			auto sum = row0[left + c] + row0[right + c] + row1[left + c] + row1[right + c] + 2u;
+			out[4u * x + c] = static_cast<sf::Uint8>(sum / 4u);
+		}
+	}
+}
+
+} // ::anonymous
+
+sf::IntRect getOpaqueBounds(sf::Image const & image) {
+	auto size = sf::Vector2i{image.getSize()};
+	auto pixels = image.getPixelsPtr();
+	if (pixels == nullptr) {
+		return {};
+	}
+
+	// single pass over all rows
+	int left{size.x}, right{-1}, top{-1}, bottom{-1};
+	for (int y = 0; y < size.y; ++y) {
+		auto row = pixels + 4 * size.x * y;
+		auto first = findFirstOpaque(row, size.x);
+		if (first == size.x) {
+			// empty row
+			continue;
+		}
+		if (top < 0) {
+			top = y;
+		}
+		bottom = y;
+		left = std::min(left, first);
+		// only search right of the current right edge
+		auto last = findLastOpaque(row, std::max(first, right + 1), size.x);
+		right = std::max(right, last);
+	}
+
+	if (top < 0) {
+		// fully transparent
+		return {};
+	}
+	return {left, top, right - left + 1, bottom - top + 1};
+}
+
+sf::Image cropImage(sf::Image const & image, sf::IntRect const & rect) {
+	sf::Image result;
+	if (rect.width <= 0 || rect.height <= 0) {
+		return result;
+	}
+	auto src = image.getPixelsPtr();
+	auto stride = 4u * image.getSize().x;
+	auto row_size = 4u * rect.width;
+	std::vector<sf::Uint8> pixels(row_size * rect.height);
+	for (int y = 0; y < rect.height; ++y) {
+		std::memcpy(&pixels[row_size * y], src + stride * (rect.top + y) + 4u * rect.left, row_size);
+	}
+	result.create(rect.width, rect.height, pixels.data());
+	return result;
+}
+
+sf::Image rotateImage(sf::Image const & image, sf::IntRect const & rect) {
+	sf::Image result;
+	if (rect.width <= 0 || rect.height <= 0) {
+		return result;
+	}
+	auto src = image.getPixelsPtr();
+	auto stride = image.getSize().x;
+	// pixel (x,y) is moved to (height-1-y, x)
+	std::vector<std::uint32_t> pixels(rect.width * rect.height);
+	for (int y = 0; y < rect.height; ++y) {
+		auto row = src + 4u * (stride * (rect.top + y) + rect.left);
+		auto column = rect.height - 1 - y;
+		for (int x = 0; x < rect.width; ++x) {
+			std::memcpy(&pixels[x * rect.height + column], row + 4u * x, 4u);
+		}
+	}
+	result.create(rect.height, rect.width, reinterpret_cast<sf::Uint8 const *>(pixels.data()));
+	return result;
+}
+
+void blitImage(sf::Image& target, sf::Vector2i const & pos, sf::Image const & source, sf::IntRect const & rect,
+	bool rotated) {
+	if (rect.width <= 0 || rect.height <= 0) {
+		return;
+	}
+	// note: sf::Image does not provide mutable access to its pixels, but
+	// the storage itself is not const
+	auto dst = const_cast<sf::Uint8*>(target.getPixelsPtr());
+	auto src = source.getPixelsPtr();
+	auto dst_stride = 4u * target.getSize().x;
+	auto src_stride = 4u * source.getSize().x;
+	if (!rotated) {
+		auto row_size = 4u * rect.width;
+		for (int y = 0; y < rect.height; ++y) {
+			std::memcpy(dst + dst_stride * (pos.y + y) + 4u * pos.x,
+				src + src_stride * (rect.top + y) + 4u * rect.left, row_size);
+		}
+		return;
+	}
+	// source row y becomes target column (height-1-y)
+	for (int y = 0; y < rect.height; ++y) {
+		auto row = src + src_stride * (rect.top + y) + 4u * rect.left;
+		auto column = dst + dst_stride * pos.y + 4u * (pos.x + rect.height - 1 - y);
+		for (int x = 0; x < rect.width; ++x) {
+			std::memcpy(column + dst_stride * x, row + 4u * x, 4u);
+		}
+	}
+}
+
+void extrudeEdges(sf::Image& image, sf::IntRect const & rect, unsigned int width) {
+	if (rect.width <= 0 || rect.height <= 0 || width == 0u) {
+		return;
+	}
+	auto pixels = const_cast<sf::Uint8*>(image.getPixelsPtr());
+	auto size = sf::Vector2i{image.getSize()};
+	auto border = static_cast<int>(width);
+	auto left = std::max(rect.left - border, 0);
+	auto right = std::min(rect.left + rect.width + border, size.x);
+	auto top = std::max(rect.top - border, 0);
+	auto bottom = std::min(rect.top + rect.height + border, size.y);
+	auto stride = 4u * size.x;
+	
+	// extend each row to the left and right
+	for (int y = rect.top; y < rect.top + rect.height; ++y) {
+		auto row = pixels + stride * y;
+		for (int x = left; x < rect.left; ++x) {
+			std::memcpy(row + 4u * x, row + 4u * rect.left, 4u);
+		}
+		for (int x = rect.left + rect.width; x < right; ++x) {
+			std::memcpy(row + 4u * x, row + 4u * (rect.left + rect.width - 1), 4u);
+		}
+	}
+	// repeat the extended first and last row
+	auto row_size = 4u * (right - left);
+	for (int y = top; y < rect.top; ++y) {
+		std::memcpy(pixels + stride * y + 4u * left, pixels + stride * rect.top + 4u * left, row_size);
+	}
+	for (int y = rect.top + rect.height; y < bottom; ++y) {
+		std::memcpy(pixels + stride * y + 4u * left, pixels + stride * (rect.top + rect.height - 1) + 4u * left, row_size);
+	}
+}
+
+std::vector<sf::Image> createMipmaps(sf::Image const & image, std::size_t num_levels, std::size_t num_threads) {
+	std::vector<sf::Image> levels;
+	auto size = image.getSize();
+	if (size.x == 0u || size.y == 0u) {
+		return levels;
+	}
+	auto const * previous = &image;
+	while ((size.x > 1u || size.y > 1u) && (num_levels == 0u || levels.size() < num_levels)) {
+		auto src_size = size;
+		size.x = std::max(size.x / 2u, 1u);
+		size.y = std::max(size.y / 2u, 1u);
+		std::vector<sf::Uint8> pixels(4u * size.x * size.y);
+		auto src = previous->getPixelsPtr();
+		parallelFor(size.y, num_threads, [&](std::size_t y) {
+			auto row0 = src + 4u * src_size.x * std::min<std::size_t>(2u * y, src_size.y - 1u);
+			auto row1 = src + 4u * src_size.x * std::min<std::size_t>(2u * y + 1u, src_size.y - 1u);
+			downsampleRows(row0, row1, src_size.x, pixels.data() + 4u * size.x * y, size.x);
+		});
+		levels.emplace_back();
+		levels.back().create(size.x, size.y, pixels.data());
+		previous = &levels.back();
+	}
+	return levels;
+}
+
+std::vector<sf::Vector2f> getConvexHull(sf::Image const & image, sf::IntRect const & rect, std::size_t max_vertices) {
+	std::vector<sf::Vector2f> result;
+	if (rect.width <= 0 || rect.height <= 0) {
+		return result;
+	}
+	
+	// outer corners of each row's first and last non-transparent pixel
+	using Point = sf::Vector2<long>;
+	std::vector<Point> points;
+	auto stride = 4u * image.getSize().x;
+	for (int y = 0; y < rect.height; ++y) {
+		auto row = image.getPixelsPtr() + stride * (rect.top + y) + 4u * rect.left;
+		auto first = findFirstOpaque(row, rect.width);
+		if (first == rect.width) {
+			continue;
+		}
+		auto last = findLastOpaque(row, first, rect.width) + 1;
+		points.push_back({first, y});
+		points.push_back({first, y + 1});
+		points.push_back({last, y});
+		points.push_back({last, y + 1});
+	}
+	if (points.empty()) {
+		return result;
+	}
+	
+	// monotone chain
+	std::sort(points.begin(), points.end(), [](Point const & lhs, Point const & rhs) {
+		return lhs.x < rhs.x || (lhs.x == rhs.x && lhs.y < rhs.y);
+	});
+	std::vector<Point> hull(2u * points.size());
+	std::size_t k{0u};
+	for (std::size_t i = 0u; i < points.size(); ++i) {
+		while (k >= 2u && cross(hull[k - 2u], hull[k - 1u], points[i]) <= 0) {
+			--k;
+		}
+		hull[k++] = points[i];
+	}
+	for (std::size_t i = points.size() - 1u, lower = k + 1u; i > 0u; --i) {
+		while (k >= lower && cross(hull[k - 2u], hull[k - 1u], points[i - 1u]) <= 0) {
+			--k;
+		}
+		hull[k++] = points[i - 1u];
+	}
+	hull.resize(k - 1u);
+	
+	// simplify
+	std::vector<sf::Vector2<double>> polygon;
+	polygon.reserve(hull.size());
+	for (auto const & point: hull) {
+		polygon.emplace_back(static_cast<double>(point.x), static_cast<double>(point.y));
+	}
+	max_vertices = std::max<std::size_t>(max_vertices, 3u);
+	sf::Vector2<double> size{static_cast<double>(rect.width), static_cast<double>(rect.height)};
+	while (polygon.size() > max_vertices && removeCheapestEdge(polygon, size)) {
+	}
+	
+	result.reserve(polygon.size());
+	for (auto const & point: polygon) {
+		result.emplace_back(static_cast<float>(point.x), static_cast<float>(point.y));
+	}
+	return result;
+}
+
+std::array<sf::Vector2f, 4u> getTexCoords(AtlasFrame const & frame) {
+	auto left = static_cast<float>(frame.clipping.left);
+	auto top = static_cast<float>(frame.clipping.top);
+	auto right = left + frame.clipping.width;
+	auto bottom = top + frame.clipping.height;
+	if (frame.rotated) {
+		// original topleft corner was moved to the topright corner
+		return {{{right, top}, {right, bottom}, {left, bottom}, {left, top}}};
+	}
+	return {{{left, top}, {right, top}, {right, bottom}, {left, bottom}}};
+}
+
+sf::Vector2f getTexCoords(AtlasFrame const & frame, sf::Vector2f const & point) {
+	auto left = static_cast<float>(frame.clipping.left);
+	auto top = static_cast<float>(frame.clipping.top);
+	if (frame.rotated) {
+		// original height is the clipping's width
+		return {left + frame.clipping.width - point.y, top + point.x};
+	}
+	return {left + point.x, top + point.y};
+}
+
+void appendHull(std::vector<sf::Vertex>& vertices, AtlasFrame const & frame, sf::Vector2f const * hulls,
+	sf::Vector2f const & position, sf::Color const & color) {
+	auto offset = position - frame.origin;
+	if (frame.hull_size < 3u) {
+		// use clipping rectangle
+		auto size = frame.rotated ? sf::Vector2f(frame.clipping.height, frame.clipping.width)
+			: sf::Vector2f(frame.clipping.width, frame.clipping.height);
+		if (size.x <= 0.f || size.y <= 0.f) {
+			return;
+		}
+		std::array<sf::Vector2f, 4u> corners{{{0.f, 0.f}, {size.x, 0.f}, size, {0.f, size.y}}};
+		for (auto i: {0u, 1u, 2u, 0u, 2u, 3u}) {
+			vertices.emplace_back(offset + corners[i], color, getTexCoords(frame, corners[i]));
+		}
+		return;
+	}
+	auto hull = hulls + frame.hull_offset;
+	vertices.reserve(vertices.size() + 3u * (frame.hull_size - 2u));
+	for (auto i = 1u; i + 1u < frame.hull_size; ++i) {
+		for (auto j: {0u, i, i + 1u}) {
+			vertices.emplace_back(offset + hull[j], color, getTexCoords(frame, hull[j]));
+		}
+	}
+}
+
+float getOverdrawReduction(AtlasFrame const & frame, sf::Vector2f const * hulls) {
+	auto rect_area = static_cast<float>(frame.clipping.width) * frame.clipping.height;
+	if (frame.hull_size < 3u || rect_area <= 0.f) {
+		return 0.f;
+	}
+	// shoelace formula
+	auto hull = hulls + frame.hull_offset;
+	float area{0.f};
+	for (auto i = 0u; i < frame.hull_size; ++i) {
+		auto const & a = hull[i];
+		auto const & b = hull[(i + 1u) % frame.hull_size];
+		area += a.x * b.y - b.x * a.y;
+	}
+	return 1.f - std::abs(area) / 2.f / rect_area;
+}
+
+std::vector<std::string> findFiles(std::string const & pattern) {
+	// split into directory (including the trailing separator) and filename
+#if defined(_WIN32)
+	auto pos = pattern.find_last_of("/\\");
+#else
+	auto pos = pattern.find_last_of('/');
+#endif
+	auto prefix = pos == std::string::npos ? std::string{} : pattern.substr(0u, pos + 1u);
+	auto filename = pattern.substr(prefix.size());
+	std::vector<std::string> result;
+	
+#if defined(_WIN32)
+	WIN32_FIND_DATAA data;
+	auto handle = FindFirstFileA((prefix + "*").c_str(), &data);
+	if (handle != INVALID_HANDLE_VALUE) {
+		do {
+			if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && matchWildcard(filename.c_str(), data.cFileName)) {
+				result.push_back(prefix + data.cFileName);
+			}
+		} while (FindNextFileA(handle, &data));
+		FindClose(handle);
+	}
+#else
+	auto directory = opendir(prefix.empty() ? "." : prefix.c_str());
+	if (directory != nullptr) {
+		while (auto entry = readdir(directory)) {
+			if (!matchWildcard(filename.c_str(), entry->d_name)) {
+				continue;
+			}
+			auto path = prefix + entry->d_name;
+			struct stat info;
+			if (stat(path.c_str(), &info) == 0 && !S_ISDIR(info.st_mode)) {
+				result.push_back(path);
+			}
+		}
+		closedir(directory);
+	}
+#endif
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+std::uint64_t hashBytes(void const * data, std::size_t size, std::uint64_t hash) {
+	// FNV-1a
+	auto bytes = static_cast<sf::Uint8 const *>(data);
+	for (auto end = bytes + size; bytes != end; ++bytes) {
+		hash ^= *bytes;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+std::uint64_t hashPixels(sf::Image const & image, sf::IntRect const & rect) {
+	std::uint64_t hash{14695981039346656037ull};
+	for (auto value: {rect.width, rect.height}) {
+		sf::Uint8 bytes[4];
+		for (auto i = 0u; i < 4u; ++i) {
+			bytes[i] = static_cast<sf::Uint8>(static_cast<std::uint32_t>(value) >> (8u * i));
+		}
+		hash = hashBytes(bytes, 4u, hash);
+	}
+	if (rect.width <= 0 || rect.height <= 0) {
+		return hash;
+	}
+	auto pixels = image.getPixelsPtr();
+	auto stride = 4u * image.getSize().x;
+	for (int y = 0; y < rect.height; ++y) {
+		hash = hashBytes(pixels + stride * (rect.top + y) + 4u * rect.left, 4u * rect.width, hash);
+	}
+	return hash;
+}
+
+bool comparePixels(sf::Image const & lhs, sf::IntRect const & lhs_rect, sf::Image const & rhs,
+	sf::IntRect const & rhs_rect, sf::Uint8 tolerance) {
+	if (lhs_rect.width != rhs_rect.width || lhs_rect.height != rhs_rect.height) {
+		return false;
+	}
+	if (lhs_rect.width <= 0 || lhs_rect.height <= 0) {
+		return true;
+	}
+	auto lhs_stride = 4u * lhs.getSize().x;
+	auto rhs_stride = 4u * rhs.getSize().x;
+	auto row_size = 4u * lhs_rect.width;
+	for (int y = 0; y < lhs_rect.height; ++y) {
+		auto a = lhs.getPixelsPtr() + lhs_stride * (lhs_rect.top + y) + 4u * lhs_rect.left;
+		auto b = rhs.getPixelsPtr() + rhs_stride * (rhs_rect.top + y) + 4u * rhs_rect.left;
+		if (tolerance == 0u) {
+			if (std::memcmp(a, b, row_size) != 0) {
+				return false;
+			}
+			continue;
+		}
+		for (auto x = 0u; x < row_size; ++x) {
+			if (std::abs(static_cast<int>(a[x]) - static_cast<int>(b[x])) > tolerance) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+} // ::sfext
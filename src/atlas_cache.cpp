@@ -0,0 +1,136 @@
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <fstream>
+
+#include <SfmlExt/atlas_cache.hpp>
+
+namespace sfext {
+
+MappedFile::MappedFile()
+	: data{nullptr}
+	, size{0u}
+#if defined(_WIN32)
+	, file{nullptr}
+	, mapping{nullptr}
+#endif
+	{
+}
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+bool MappedFile::open(std::string const & filename) {
+	close();
+#if defined(_WIN32)
+	file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		file = nullptr;
+		return false;
+	}
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+		close();
+		return false;
+	}
+	mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr) {
+		close();
+		return false;
+	}
+	data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (data == nullptr) {
+		close();
+		return false;
+	}
+	size = static_cast<std::size_t>(file_size.QuadPart);
+#else
+	auto fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size == 0) {
+		::close(fd);
+		return false;
+	}
+	auto ptr = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// note: the mapping stays valid after closing the descriptor
+	::close(fd);
+	if (ptr == MAP_FAILED) {
+		return false;
+	}
+	data = ptr;
+	size = static_cast<std::size_t>(info.st_size);
+#endif
+	return true;
+}
+
+void MappedFile::close() {
+#if defined(_WIN32)
+	if (data != nullptr) {
+		UnmapViewOfFile(data);
+	}
+	if (mapping != nullptr) {
+		CloseHandle(mapping);
+	}
+	if (file != nullptr) {
+		CloseHandle(file);
+	}
+	mapping = nullptr;
+	file = nullptr;
+#else
+	if (data != nullptr) {
+		munmap(const_cast<void *>(data), size);
+	}
+#endif
+	data = nullptr;
+	size = 0u;
+}
+
+void const * MappedFile::getData() const {
+	return data;
+}
+
+std::size_t MappedFile::getSize() const {
+	return size;
+}
+
+// ---------------------------------------------------------------------------
+
+std::uint64_t hashCombine(std::uint64_t seed, std::uint64_t value) {
+	// 64-bit variant of boost::hash_combine
+	return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 12u) + (seed >> 4u));
+}
+
+std::uint64_t hashFiles(std::vector<std::string> const & filenames) {
+	std::uint64_t hash{0u};
+	std::vector<char> buffer(1u << 16u);
+	for (auto const & filename: filenames) {
+		hash = hashCombine(hash, hashBytes(filename.data(), filename.size()));
+		std::ifstream file{filename, std::ios::binary};
+		if (!file) {
+			continue;
+		}
+		auto content = hashBytes(nullptr, 0u);
+		std::uint64_t size{0u};
+		while (file) {
+			file.read(buffer.data(), buffer.size());
+			auto num_read = static_cast<std::size_t>(file.gcount());
+			content = hashBytes(buffer.data(), num_read, content);
+			size += num_read;
+		}
+		hash = hashCombine(hash, size);
+		hash = hashCombine(hash, content);
+	}
+	return hash;
+}
+
+} // ::sfext
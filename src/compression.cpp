@@ -0,0 +1,753 @@
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SFEXT_SSE2
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include <SfmlExt/compression.hpp>
+#include <SfmlExt/parallel.hpp>
+
+namespace sfext {
+
+namespace {
+
+/// Pixels of a 4x4 block (row by row)
+struct Block {
+	std::uint8_t rgba[16][4];
+};
+
+/// Four palette colors
+struct Palette {
+	alignas(16) float r[4];
+	alignas(16) float g[4];
+	alignas(16) float b[4];
+};
+
+/// Eight palette alpha values
+struct AlphaPalette {
+	alignas(16) float a[8];
+};
+
+/// ETC1 intensity modifiers (+a, +b, -a, -b) per table
+int const etc_modifiers[8][4] = {
+	{2, 8, -2, -8}, {5, 17, -5, -17}, {9, 29, -9, -29}, {13, 42, -13, -42},
+	{18, 60, -18, -60}, {24, 80, -24, -80}, {33, 106, -33, -106}, {47, 183, -47, -183}
+};
+
+/// EAC alpha modifiers per table
+int const eac_modifiers[16][8] = {
+	{-3, -6, -9, -15, 2, 5, 8, 14}, {-3, -7, -10, -13, 2, 6, 9, 12},
+	{-2, -5, -8, -13, 1, 4, 7, 12}, {-2, -4, -6, -13, 1, 3, 5, 12},
+	{-3, -6, -8, -12, 2, 5, 7, 11}, {-3, -7, -9, -11, 2, 6, 8, 10},
+	{-4, -7, -8, -11, 3, 6, 7, 10}, {-3, -5, -8, -11, 2, 4, 7, 10},
+	{-2, -6, -8, -10, 1, 5, 7, 9}, {-2, -5, -8, -10, 1, 4, 7, 9},
+	{-2, -4, -8, -10, 1, 3, 7, 9}, {-2, -5, -7, -10, 1, 4, 6, 9},
+	{-3, -4, -7, -10, 2, 3, 6, 9}, {-1, -2, -3, -10, 0, 1, 2, 9},
+	{-4, -6, -8, -9, 3, 5, 7, 8}, {-3, -5, -7, -9, 2, 4, 6, 8}
+};
+
+int clamp(int value, int low, int high) {
+	return std::min(std::max(value, low), high);
+}
+
+// ---------------------------------------------------------------------------
+// palette search
+
+/// Determine nearest palette color
+/**
+ * @param [out] dist squared distance to the nearest color
+ * @return index of the nearest color (lowest index on ties)
+ */
+int findNearest(Palette const & palette, float r, float g, float b, float& dist) {
+#if defined(SFEXT_SSE2)
+	// test all four colors at once
+	auto dr = _mm_sub_ps(_mm_load_ps(palette.r), _mm_set1_ps(r));
+	auto dg = _mm_sub_ps(_mm_load_ps(palette.g), _mm_set1_ps(g));
+	auto db = _mm_sub_ps(_mm_load_ps(palette.b), _mm_set1_ps(b));
+	auto d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+	auto m = _mm_min_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 3, 0, 1)));
+	m = _mm_min_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+	auto mask = _mm_movemask_ps(_mm_cmpeq_ps(d, m));
+	dist = _mm_cvtss_f32(m);
+	int index{0};
+	while ((mask & (1 << index)) == 0) {
+		++index;
+	}
+	return index;
+#else
+	int index{0};
+	dist = -1.f;
+	for (int i = 0; i < 4; ++i) {
+		auto dr = palette.r[i] - r;
+		auto dg = palette.g[i] - g;
+		auto db = palette.b[i] - b;
+		auto d = dr * dr + dg * dg + db * db;
+		if (dist < 0.f || d < dist) {
+			dist = d;
+			index = i;
+		}
+	}
+	return index;
+#endif
+}
+
+/// Determine nearest palette alpha value
+/**
+ * @param [out] dist squared distance to the nearest value
+ * @return index of the nearest value (lowest index on ties)
+ */
+int findNearest(AlphaPalette const & palette, float a, float& dist) {
+#if defined(SFEXT_SSE2)
+	auto value = _mm_set1_ps(a);
+	auto d0 = _mm_sub_ps(_mm_load_ps(palette.a), value);
+	auto d1 = _mm_sub_ps(_mm_load_ps(palette.a + 4), value);
+	d0 = _mm_mul_ps(d0, d0);
+	d1 = _mm_mul_ps(d1, d1);
+	auto m = _mm_min_ps(d0, d1);
+	m = _mm_min_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+	m = _mm_min_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+	auto mask = _mm_movemask_ps(_mm_cmpeq_ps(d0, m)) | (_mm_movemask_ps(_mm_cmpeq_ps(d1, m)) << 4);
+	dist = _mm_cvtss_f32(m);
+	int index{0};
+	while ((mask & (1 << index)) == 0) {
+		++index;
+	}
+	return index;
+#else
+	int index{0};
+	dist = -1.f;
+	for (int i = 0; i < 8; ++i) {
+		auto d = (palette.a[i] - a) * (palette.a[i] - a);
+		if (dist < 0.f || d < dist) {
+			dist = d;
+			index = i;
+		}
+	}
+	return index;
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// BC1 color block
+
+void unpack565(std::uint16_t color, int rgb[3]) {
+	auto r = (color >> 11) & 31;
+	auto g = (color >> 5) & 63;
+	auto b = color & 31;
+	rgb[0] = (r << 3) | (r >> 2);
+	rgb[1] = (g << 2) | (g >> 4);
+	rgb[2] = (b << 3) | (b >> 2);
+}
+
+std::uint16_t pack565(float r, float g, float b) {
+	auto r5 = clamp(static_cast<int>(std::lround(r * 31.f / 255.f)), 0, 31);
+	auto g6 = clamp(static_cast<int>(std::lround(g * 63.f / 255.f)), 0, 63);
+	auto b5 = clamp(static_cast<int>(std::lround(b * 31.f / 255.f)), 0, 31);
+	return static_cast<std::uint16_t>((r5 << 11) | (g6 << 5) | b5);
+}
+
+/// Determine the colors of a BC1 color block
+/**
+ * In three color mode, the fourth entry (transparent) is never the
+ * nearest color.
+ */
+void createPalette(std::uint16_t c0, std::uint16_t c1, bool four_colors, Palette& palette) {
+	int a[3], b[3];
+	unpack565(c0, a);
+	unpack565(c1, b);
+	for (int i = 0; i < 3; ++i) {
+		float values[4];
+		values[0] = static_cast<float>(a[i]);
+		values[1] = static_cast<float>(b[i]);
+		if (four_colors) {
+			values[2] = static_cast<float>((2 * a[i] + b[i]) / 3);
+			values[3] = static_cast<float>((a[i] + 2 * b[i]) / 3);
+		} else {
+			values[2] = static_cast<float>((a[i] + b[i]) / 2);
+			values[3] = 1e6f;
+		}
+		auto channel = (i == 0) ? palette.r : (i == 1) ? palette.g : palette.b;
+		std::copy(values, values + 4, channel);
+	}
+}
+
+/// Encode colors of a block as BC1 color block
+/**
+ * @param punchthrough if true, pixels with alpha below 128 become transparent
+ */
+void encodeColor(Block const & block, bool punchthrough, std::uint8_t* out) {
+	// determine weighted mean of relevant pixels
+	bool transparent[16];
+	bool any_transparent{false};
+	float weight[16];
+	float mean[3] = {0.f, 0.f, 0.f};
+	float total{0.f};
+	for (int i = 0; i < 16; ++i) {
+		auto alpha = block.rgba[i][3];
+		transparent[i] = punchthrough && alpha < 128u;
+		any_transparent = any_transparent || transparent[i];
+		weight[i] = (transparent[i] || alpha == 0u) ? 0.f : 1.f;
+		for (int c = 0; c < 3; ++c) {
+			mean[c] += weight[i] * block.rgba[i][c];
+		}
+		total += weight[i];
+	}
+	std::uint16_t c0{0u}, c1{0u};
+	if (total > 0.f) {
+		for (auto& value: mean) {
+			value /= total;
+		}
+
+		// principal axis by power iteration, starting at the bounding box' diagonal
+		float cov[6] = {0.f, 0.f, 0.f, 0.f, 0.f, 0.f};
+		float low[3] = {255.f, 255.f, 255.f}, high[3] = {0.f, 0.f, 0.f};
+		for (int i = 0; i < 16; ++i) {
+			if (weight[i] == 0.f) {
+				continue;
+			}
+			float d[3];
+			for (int c = 0; c < 3; ++c) {
+				d[c] = block.rgba[i][c] - mean[c];
+				low[c] = std::min<float>(low[c], block.rgba[i][c]);
+				high[c] = std::max<float>(high[c], block.rgba[i][c]);
+			}
+			cov[0] += d[0] * d[0];
+			cov[1] += d[0] * d[1];
+			cov[2] += d[0] * d[2];
+			cov[3] += d[1] * d[1];
+			cov[4] += d[1] * d[2];
+			cov[5] += d[2] * d[2];
+		}
+		float axis[3] = {high[0] - low[0], high[1] - low[1], high[2] - low[2]};
+		for (int iteration = 0; iteration < 4; ++iteration) {
+			float next[3] = {
+				cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2],
+				cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2],
+				cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2]
+			};
+			auto length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]);
+			if (length < 1e-6f) {
+				break;
+			}
+			for (int c = 0; c < 3; ++c) {
+				axis[c] = next[c] / length;
+			}
+		}
+		auto length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+		if (length > 1e-6f) {
+			for (auto& value: axis) {
+				value /= length;
+			}
+		}
+
+		// endpoints at the extreme projections
+		float t_min{0.f}, t_max{0.f};
+		for (int i = 0; i < 16; ++i) {
+			if (weight[i] == 0.f) {
+				continue;
+			}
+			float t{0.f};
+			for (int c = 0; c < 3; ++c) {
+				t += (block.rgba[i][c] - mean[c]) * axis[c];
+			}
+			t_min = std::min(t_min, t);
+			t_max = std::max(t_max, t);
+		}
+		c0 = pack565(mean[0] + axis[0] * t_max, mean[1] + axis[1] * t_max, mean[2] + axis[2] * t_max);
+		c1 = pack565(mean[0] + axis[0] * t_min, mean[1] + axis[1] * t_min, mean[2] + axis[2] * t_min);
+	}
+
+	// three color mode requires c0 <= c1, four color mode c0 > c1
+	bool three_colors = punchthrough && any_transparent;
+	if (three_colors ? (c0 > c1) : (c0 < c1)) {
+		std::swap(c0, c1);
+	}
+	Palette palette;
+	createPalette(c0, c1, c0 > c1 || !punchthrough, palette);
+	std::uint32_t indices{0u};
+	for (int i = 0; i < 16; ++i) {
+		std::uint32_t index{3u};
+		if (!transparent[i]) {
+			float dist;
+			index = findNearest(palette, block.rgba[i][0], block.rgba[i][1], block.rgba[i][2], dist);
+		}
+		indices |= index << (2 * i);
+	}
+	out[0] = static_cast<std::uint8_t>(c0);
+	out[1] = static_cast<std::uint8_t>(c0 >> 8);
+	out[2] = static_cast<std::uint8_t>(c1);
+	out[3] = static_cast<std::uint8_t>(c1 >> 8);
+	for (int i = 0; i < 4; ++i) {
+		out[4 + i] = static_cast<std::uint8_t>(indices >> (8 * i));
+	}
+}
+
+/// Decode BC1 color block
+/**
+ * @param four_colors if true, the block is always decoded in four color mode (BC3)
+ */
+void decodeColor(std::uint8_t const * in, bool four_colors, Block& block) {
+	std::uint16_t c0 = in[0] | (in[1] << 8);
+	std::uint16_t c1 = in[2] | (in[3] << 8);
+	std::uint32_t indices = in[4] | (in[5] << 8) | (in[6] << 16) | (static_cast<std::uint32_t>(in[7]) << 24);
+	four_colors = four_colors || c0 > c1;
+	Palette palette;
+	createPalette(c0, c1, four_colors, palette);
+	for (int i = 0; i < 16; ++i) {
+		auto index = (indices >> (2 * i)) & 3u;
+		if (!four_colors && index == 3u) {
+			block.rgba[i][0] = block.rgba[i][1] = block.rgba[i][2] = block.rgba[i][3] = 0u;
+			continue;
+		}
+		block.rgba[i][0] = static_cast<std::uint8_t>(palette.r[index]);
+		block.rgba[i][1] = static_cast<std::uint8_t>(palette.g[index]);
+		block.rgba[i][2] = static_cast<std::uint8_t>(palette.b[index]);
+		block.rgba[i][3] = 255u;
+	}
+}
+
+// ---------------------------------------------------------------------------
+// BC3 alpha block
+
+void createAlphaPalette(int a0, int a1, AlphaPalette& palette) {
+	palette.a[0] = static_cast<float>(a0);
+	palette.a[1] = static_cast<float>(a1);
+	if (a0 > a1) {
+		for (int i = 2; i < 8; ++i) {
+			palette.a[i] = static_cast<float>(((8 - i) * a0 + (i - 1) * a1) / 7);
+		}
+	} else {
+		for (int i = 2; i < 6; ++i) {
+			palette.a[i] = static_cast<float>(((6 - i) * a0 + (i - 1) * a1) / 5);
+		}
+		palette.a[6] = 0.f;
+		palette.a[7] = 255.f;
+	}
+}
+
+/// Determine indices of all pixels' alpha values
+/**
+ * @return sum of squared errors
+ */
+float findAlphaIndices(Block const & block, AlphaPalette const & palette, int indices[16]) {
+	float error{0.f};
+	for (int i = 0; i < 16; ++i) {
+		float dist;
+		indices[i] = findNearest(palette, block.rgba[i][3], dist);
+		error += dist;
+	}
+	return error;
+}
+
+void encodeAlpha(Block const & block, std::uint8_t* out) {
+	// eight values between min and max or six values and explicit 0 and 255
+	int low{255}, high{0}, inner_low{255}, inner_high{0};
+	for (int i = 0; i < 16; ++i) {
+		int alpha = block.rgba[i][3];
+		low = std::min(low, alpha);
+		high = std::max(high, alpha);
+		if (alpha > 0 && alpha < 255) {
+			inner_low = std::min(inner_low, alpha);
+			inner_high = std::max(inner_high, alpha);
+		}
+	}
+	if (inner_low > inner_high) {
+		inner_low = inner_high = 0;
+	}
+	int a0{inner_low}, a1{inner_high};
+	AlphaPalette palette;
+	int indices[16];
+	createAlphaPalette(a0, a1, palette);
+	auto error = findAlphaIndices(block, palette, indices);
+	if (high > low && error > 0.f) {
+		int other[16];
+		createAlphaPalette(high, low, palette);
+		if (findAlphaIndices(block, palette, other) < error) {
+			a0 = high;
+			a1 = low;
+			std::copy(other, other + 16, indices);
+		}
+	}
+	out[0] = static_cast<std::uint8_t>(a0);
+	out[1] = static_cast<std::uint8_t>(a1);
+	std::uint64_t bits{0u};
+	for (int i = 0; i < 16; ++i) {
+		bits |= static_cast<std::uint64_t>(indices[i]) << (3 * i);
+	}
+	for (int i = 0; i < 6; ++i) {
+		out[2 + i] = static_cast<std::uint8_t>(bits >> (8 * i));
+	}
+}
+
+void decodeAlpha(std::uint8_t const * in, Block& block) {
+	AlphaPalette palette;
+	createAlphaPalette(in[0], in[1], palette);
+	std::uint64_t bits{0u};
+	for (int i = 0; i < 6; ++i) {
+		bits |= static_cast<std::uint64_t>(in[2 + i]) << (8 * i);
+	}
+	for (int i = 0; i < 16; ++i) {
+		block.rgba[i][3] = static_cast<std::uint8_t>(palette.a[(bits >> (3 * i)) & 7u]);
+	}
+}
+
+// ---------------------------------------------------------------------------
+// ETC2 color block (individual and differential mode) and EAC alpha block
+
+/// Write 64 bits in big-endian byte order
+void storeBigEndian(std::uint64_t bits, std::uint8_t* out) {
+	for (int i = 0; i < 8; ++i) {
+		out[i] = static_cast<std::uint8_t>(bits >> (56 - 8 * i));
+	}
+}
+
+std::uint64_t loadBigEndian(std::uint8_t const * in) {
+	std::uint64_t bits{0u};
+	for (int i = 0; i < 8; ++i) {
+		bits = (bits << 8u) | in[i];
+	}
+	return bits;
+}
+
+/// Determine subblock of a pixel (given row by row)
+int getSubblock(int pixel, bool flip) {
+	return flip ? (pixel / 4 >= 2) : (pixel % 4 >= 2);
+}
+
+/// Find best modifier table of a subblock
+/**
+ * @return sum of squared errors
+ */
+float fitSubblock(Block const & block, float const weight[16], bool flip, int subblock, int const base[3],
+	int& table, int indices[16]) {
+	float best{-1.f};
+	for (int t = 0; t < 8; ++t) {
+		Palette palette;
+		for (int i = 0; i < 4; ++i) {
+			palette.r[i] = static_cast<float>(clamp(base[0] + etc_modifiers[t][i], 0, 255));
+			palette.g[i] = static_cast<float>(clamp(base[1] + etc_modifiers[t][i], 0, 255));
+			palette.b[i] = static_cast<float>(clamp(base[2] + etc_modifiers[t][i], 0, 255));
+		}
+		float error{0.f};
+		int tmp[16];
+		for (int i = 0; i < 16; ++i) {
+			if (getSubblock(i, flip) != subblock) {
+				continue;
+			}
+			float dist;
+			tmp[i] = findNearest(palette, block.rgba[i][0], block.rgba[i][1], block.rgba[i][2], dist);
+			error += weight[i] * dist;
+		}
+		if (best < 0.f || error < best) {
+			best = error;
+			table = t;
+			for (int i = 0; i < 16; ++i) {
+				if (getSubblock(i, flip) == subblock) {
+					indices[i] = tmp[i];
+				}
+			}
+		}
+	}
+	return best;
+}
+
+void encodeEtcColor(Block const & block, std::uint8_t* out) {
+	// color of transparent pixels is irrelevant
+	float weight[16];
+	for (int i = 0; i < 16; ++i) {
+		weight[i] = (block.rgba[i][3] > 0u) ? 1.f : 0.f;
+	}
+	float best_error{-1.f};
+	std::uint64_t best_bits{0u};
+	for (int flip = 0; flip < 2; ++flip) {
+		// average color per subblock
+		float mean[2][3] = {{0.f, 0.f, 0.f}, {0.f, 0.f, 0.f}};
+		float total[2] = {0.f, 0.f};
+		for (int i = 0; i < 16; ++i) {
+			auto s = getSubblock(i, flip != 0);
+			for (int c = 0; c < 3; ++c) {
+				mean[s][c] += weight[i] * block.rgba[i][c];
+			}
+			total[s] += weight[i];
+		}
+		int q5[2][3], q4[2][3];
+		bool differential{true};
+		for (int s = 0; s < 2; ++s) {
+			for (int c = 0; c < 3; ++c) {
+				auto value = (total[s] > 0.f) ? mean[s][c] / total[s] : 0.f;
+				q5[s][c] = clamp(static_cast<int>(std::lround(value * 31.f / 255.f)), 0, 31);
+				q4[s][c] = clamp(static_cast<int>(std::lround(value * 15.f / 255.f)), 0, 15);
+			}
+		}
+		for (int c = 0; c < 3; ++c) {
+			auto delta = q5[1][c] - q5[0][c];
+			differential = differential && delta >= -4 && delta <= 3;
+		}
+
+		// try differential (if possible) and individual mode
+		for (int mode = differential ? 0 : 1; mode < 2; ++mode) {
+			int base[2][3];
+			for (int s = 0; s < 2; ++s) {
+				for (int c = 0; c < 3; ++c) {
+					base[s][c] = (mode == 0) ? ((q5[s][c] << 3) | (q5[s][c] >> 2)) : q4[s][c] * 17;
+				}
+			}
+			int tables[2], indices[16];
+			auto error = fitSubblock(block, weight, flip != 0, 0, base[0], tables[0], indices)
+				+ fitSubblock(block, weight, flip != 0, 1, base[1], tables[1], indices);
+			if (best_error >= 0.f && error >= best_error) {
+				continue;
+			}
+			best_error = error;
+			std::uint64_t bits{0u};
+			for (int c = 0; c < 3; ++c) {
+				auto shift = 56 - 8 * c;
+				if (mode == 0) {
+					bits |= static_cast<std::uint64_t>(q5[0][c]) << (shift + 3);
+					bits |= static_cast<std::uint64_t>((q5[1][c] - q5[0][c]) & 7) << shift;
+				} else {
+					bits |= static_cast<std::uint64_t>(q4[0][c]) << (shift + 4);
+					bits |= static_cast<std::uint64_t>(q4[1][c]) << shift;
+				}
+			}
+			bits |= static_cast<std::uint64_t>(tables[0]) << 37;
+			bits |= static_cast<std::uint64_t>(tables[1]) << 34;
+			bits |= static_cast<std::uint64_t>(mode == 0) << 33;
+			bits |= static_cast<std::uint64_t>(flip) << 32;
+			// pixels are indexed column by column
+			for (int i = 0; i < 16; ++i) {
+				auto k = (i % 4) * 4 + i / 4;
+				bits |= static_cast<std::uint64_t>(indices[i] >> 1) << (16 + k);
+				bits |= static_cast<std::uint64_t>(indices[i] & 1) << k;
+			}
+			best_bits = bits;
+		}
+	}
+	storeBigEndian(best_bits, out);
+}
+
+void decodeEtcColor(std::uint8_t const * in, Block& block) {
+	auto bits = loadBigEndian(in);
+	bool differential = ((bits >> 33) & 1u) != 0u;
+	bool flip = ((bits >> 32) & 1u) != 0u;
+	int base[2][3];
+	for (int c = 0; c < 3; ++c) {
+		auto shift = 56 - 8 * c;
+		if (differential) {
+			int first = (bits >> (shift + 3)) & 31u;
+			int delta = (bits >> shift) & 7u;
+			delta = (delta >= 4) ? delta - 8 : delta;
+			// note: overflow would denote T, H or planar mode
+			int second = clamp(first + delta, 0, 31);
+			base[0][c] = (first << 3) | (first >> 2);
+			base[1][c] = (second << 3) | (second >> 2);
+		} else {
+			base[0][c] = ((bits >> (shift + 4)) & 15u) * 17;
+			base[1][c] = ((bits >> shift) & 15u) * 17;
+		}
+	}
+	int tables[2] = {static_cast<int>((bits >> 37) & 7u), static_cast<int>((bits >> 34) & 7u)};
+	for (int i = 0; i < 16; ++i) {
+		auto k = (i % 4) * 4 + i / 4;
+		auto index = (((bits >> (16 + k)) & 1u) << 1) | ((bits >> k) & 1u);
+		auto s = getSubblock(i, flip);
+		for (int c = 0; c < 3; ++c) {
+			block.rgba[i][c] = static_cast<std::uint8_t>(clamp(base[s][c] + etc_modifiers[tables[s]][index], 0, 255));
+		}
+	}
+}
+
+void encodeEacAlpha(Block const & block, std::uint8_t* out) {
+	int low{255}, high{0};
+	for (int i = 0; i < 16; ++i) {
+		low = std::min<int>(low, block.rgba[i][3]);
+		high = std::max<int>(high, block.rgba[i][3]);
+	}
+	// constant alpha using the zero modifier of table 13
+	int best_base{low}, best_multiplier{1}, best_table{13};
+	int best_indices[16];
+	std::fill(best_indices, best_indices + 16, 4);
+	if (high > low) {
+		float best_error{-1.f};
+		for (int t = 0; t < 16; ++t) {
+			auto span = eac_modifiers[t][7] - eac_modifiers[t][3];
+			auto guess = clamp(static_cast<int>(std::lround(static_cast<float>(high - low) / span)), 1, 15);
+			for (auto multiplier = std::max(guess - 1, 1); multiplier <= std::min(guess + 1, 15); ++multiplier) {
+				auto center = (high + low) / 2.f - multiplier * (eac_modifiers[t][7] + eac_modifiers[t][3]) / 2.f;
+				auto base = clamp(static_cast<int>(std::lround(center)), 0, 255);
+				AlphaPalette palette;
+				for (int i = 0; i < 8; ++i) {
+					palette.a[i] = static_cast<float>(clamp(base + eac_modifiers[t][i] * multiplier, 0, 255));
+				}
+				int indices[16];
+				auto error = findAlphaIndices(block, palette, indices);
+				if (best_error < 0.f || error < best_error) {
+					best_error = error;
+					best_base = base;
+					best_multiplier = multiplier;
+					best_table = t;
+					std::copy(indices, indices + 16, best_indices);
+				}
+			}
+		}
+	}
+	std::uint64_t bits = static_cast<std::uint64_t>(best_base) << 56;
+	bits |= static_cast<std::uint64_t>(best_multiplier) << 52;
+	bits |= static_cast<std::uint64_t>(best_table) << 48;
+	for (int i = 0; i < 16; ++i) {
+		auto k = (i % 4) * 4 + i / 4;
+		bits |= static_cast<std::uint64_t>(best_indices[i]) << (45 - 3 * k);
+	}
+	storeBigEndian(bits, out);
+}
+
+void decodeEacAlpha(std::uint8_t const * in, Block& block) {
+	auto bits = loadBigEndian(in);
+	int base = (bits >> 56) & 255u;
+	int multiplier = (bits >> 52) & 15u;
+	int table = (bits >> 48) & 15u;
+	for (int i = 0; i < 16; ++i) {
+		auto k = (i % 4) * 4 + i / 4;
+		auto index = (bits >> (45 - 3 * k)) & 7u;
+		block.rgba[i][3] = static_cast<std::uint8_t>(clamp(base + eac_modifiers[table][index] * multiplier, 0, 255));
+	}
+}
+
+// ---------------------------------------------------------------------------
+
+/// Read a block, replicating edge pixels outside the image
+void loadBlock(sf::Uint8 const * pixels, sf::Vector2u const & size, unsigned int x, unsigned int y, Block& block) {
+	for (auto i = 0u; i < 16u; ++i) {
+		auto sx = std::min(4u * x + i % 4u, size.x - 1u);
+		auto sy = std::min(4u * y + i / 4u, size.y - 1u);
+		std::memcpy(block.rgba[i], pixels + 4u * (sy * size.x + sx), 4u);
+	}
+}
+
+/// Write the part of a block inside the image
+void storeBlock(Block const & block, sf::Vector2u const & size, unsigned int x, unsigned int y, sf::Uint8* pixels) {
+	for (auto i = 0u; i < 16u; ++i) {
+		auto dx = 4u * x + i % 4u;
+		auto dy = 4u * y + i / 4u;
+		if (dx < size.x && dy < size.y) {
+			std::memcpy(pixels + 4u * (dy * size.x + dx), block.rgba[i], 4u);
+		}
+	}
+}
+
+} // ::anonymous
+
+std::size_t getBlockSize(BlockFormat format) {
+	switch (format) {
+		case BlockFormat::None: return 4u;
+		case BlockFormat::BC1: return 8u;
+		case BlockFormat::BC3: return 16u;
+		case BlockFormat::ETC2: return 16u;
+	}
+	return 0u;
+}
+
+CompressedImage compressImage(sf::Image const & image, BlockFormat format, std::size_t num_threads) {
+	if (format == BlockFormat::None) {
+		throw std::invalid_argument("Block format required");
+	}
+	CompressedImage result;
+	result.format = format;
+	result.size = image.getSize();
+	if (result.size.x == 0u || result.size.y == 0u) {
+		return result;
+	}
+	auto block_size = getBlockSize(format);
+	auto blocks_x = (result.size.x + 3u) / 4u;
+	auto blocks_y = (result.size.y + 3u) / 4u;
+	result.blocks.resize(block_size * blocks_x * blocks_y);
+
+	// encode rows of blocks concurrently
+	auto pixels = image.getPixelsPtr();
+	parallelFor(blocks_y, num_threads, [&](std::size_t y) {
+		Block block;
+		for (auto x = 0u; x < blocks_x; ++x) {
+			loadBlock(pixels, result.size, x, y, block);
+			auto out = result.blocks.data() + block_size * (y * blocks_x + x);
+			switch (format) {
+				case BlockFormat::BC1:
+					encodeColor(block, true, out);
+					break;
+				case BlockFormat::BC3:
+					encodeAlpha(block, out);
+					encodeColor(block, false, out + 8);
+					break;
+				case BlockFormat::ETC2:
+					encodeEacAlpha(block, out);
+					encodeEtcColor(block, out + 8);
+					break;
+				case BlockFormat::None:
+					break;
+			}
+		}
+	});
+	return result;
+}
+
+sf::Image decompressImage(CompressedImage const & image, std::size_t num_threads) {
+	sf::Image result;
+	if (image.size.x == 0u || image.size.y == 0u) {
+		return result;
+	}
+	auto block_size = getBlockSize(image.format);
+	auto blocks_x = (image.size.x + 3u) / 4u;
+	auto blocks_y = (image.size.y + 3u) / 4u;
+	std::vector<sf::Uint8> pixels(4u * image.size.x * image.size.y);
+	parallelFor(blocks_y, num_threads, [&](std::size_t y) {
+		Block block;
+		for (auto x = 0u; x < blocks_x; ++x) {
+			auto in = image.blocks.data() + block_size * (y * blocks_x + x);
+			switch (image.format) {
+				case BlockFormat::BC1:
+					decodeColor(in, false, block);
+					break;
+				case BlockFormat::BC3:
+					decodeColor(in + 8, true, block);
+					decodeAlpha(in, block);
+					break;
+				case BlockFormat::ETC2:
+					decodeEtcColor(in + 8, block);
+					decodeEacAlpha(in, block);
+					break;
+				case BlockFormat::None:
+					break;
+			}
+			storeBlock(block, image.size, x, y, pixels.data());
+		}
+	});
+	result.create(image.size.x, image.size.y, pixels.data());
+	return result;
+}
+
+float getCompressionError(sf::Image const & original, sf::Image const & decoded, sf::IntRect const & rect) {
+	if (rect.width <= 0 || rect.height <= 0) {
+		return 0.f;
+	}
+	auto lhs_stride = 4u * original.getSize().x;
+	auto rhs_stride = 4u * decoded.getSize().x;
+	double sum{0.0};
+	for (int y = 0; y < rect.height; ++y) {
+		auto a = original.getPixelsPtr() + lhs_stride * (rect.top + y) + 4u * rect.left;
+		auto b = decoded.getPixelsPtr() + rhs_stride * (rect.top + y) + 4u * rect.left;
+		for (int x = 0; x < rect.width; ++x, a += 4, b += 4) {
+			// color of fully transparent pixels is irrelevant
+			int first = (a[3] == 0u) ? 3 : 0;
+			for (int c = first; c < 4; ++c) {
+				auto diff = static_cast<double>(a[c]) - b[c];
+				sum += diff * diff;
+			}
+		}
+	}
+	return static_cast<float>(std::sqrt(sum / (4.0 * rect.width * rect.height)));
+}
+
+} // ::sfext
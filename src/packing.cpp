@@ -0,0 +1,589 @@
+#include <algorithm>
+#include <limits>
+#include <boost/math/common_factor_rt.hpp>
+
+#include <SfmlExt/packing.hpp>
+
+namespace sfext {
+
+RectPacker::~RectPacker() {
+}
+
+// ---------------------------------------------------------------------------
+
+OccupancyGrid::OccupancyGrid(int cell_size)
+	: cell_size{cell_size}
+	, num_cells{}
+	, rects{}
+	, cells{} {
+}
+
+void OccupancyGrid::reset(sf::Vector2u const & size) {
+	num_cells.x = (static_cast<int>(size.x) + cell_size - 1) / cell_size;
+	num_cells.y = (static_cast<int>(size.y) + cell_size - 1) / cell_size;
+	rects.clear();
+	cells.clear();
+	cells.resize(num_cells.x * num_cells.y);
+}
+
+void OccupancyGrid::resize(sf::Vector2u const & size) {
+	auto placed = std::move(rects);
+	reset(size);
+	for (auto const & rect: placed) {
+		add(rect);
+	}
+}
+
+void OccupancyGrid::add(sf::IntRect const & rect) {
+	auto index = rects.size();
+	rects.push_back(rect);
+	auto right = std::min((rect.left + rect.width - 1) / cell_size, num_cells.x - 1);
+	auto bottom = std::min((rect.top + rect.height - 1) / cell_size, num_cells.y - 1);
+	for (auto y = rect.top / cell_size; y <= bottom; ++y) {
+		for (auto x = rect.left / cell_size; x <= right; ++x) {
+			cells[y * num_cells.x + x].push_back(index);
+		}
+	}
+}
+
+sf::IntRect const * OccupancyGrid::findCollision(sf::IntRect const & rect) const {
+	auto right = std::min((rect.left + rect.width - 1) / cell_size, num_cells.x - 1);
+	auto bottom = std::min((rect.top + rect.height - 1) / cell_size, num_cells.y - 1);
+	for (auto y = rect.top / cell_size; y <= bottom; ++y) {
+		for (auto x = rect.left / cell_size; x <= right; ++x) {
+			for (auto index: cells[y * num_cells.x + x]) {
+				if (rect.intersects(rects[index])) {
+					return &rects[index];
+				}
+			}
+		}
+	}
+	return nullptr;
+}
+
+bool OccupancyGrid::isEmpty() const {
+	return rects.empty();
+}
+
+// ---------------------------------------------------------------------------
+
+ScanPacker::ScanPacker(sf::Vector2u const & min_step)
+	: min_step{min_step}
+	, size{}
+	, step_range{min_step}
+	, used{} {
+}
+
+void ScanPacker::reset(sf::Vector2u const & size) {
+	this->size = sf::Vector2i{size};
+	step_range = sf::Vector2i{min_step};
+	used.reset(size);
+}
+
+bool ScanPacker::find(sf::Vector2i const & size, sf::Vector2i& pos) const {
+	if (size.x > this->size.x || size.y > this->size.y) {
+		return false;
+	}
+
+	// search for space
+	auto max_left	= this->size.x - size.x;
+	auto max_top	= this->size.y - size.y;
+	sf::IntRect target{{0, 0}, size};
+	for (target.top = 0; target.top <= max_top; target.top += step_range.y) {
+		target.left = 0;
+		while (target.left <= max_left) {
+			auto other = used.findCollision(target);
+			if (other != nullptr) {
+				// collision with another rectangle: all positions of this
+				// row left of its right edge collide as well, so skip them
+				auto right = other->left + other->width;
+				target.left += (right - target.left + step_range.x - 1) / step_range.x * step_range.x;
+				continue;
+			}
+			pos = {target.left, target.top};
+			return true;
+		}
+	}
+
+	// no space found
+	return false;
+}
+
+bool ScanPacker::insert(sf::Vector2i const & size, sf::Vector2i& pos, bool* rotated) {
+	sf::Vector2i turned{size.y, size.x};
+	bool turn{false};
+	if (used.isEmpty()) {
+		// placed at (0,0), turned only if necessary
+		pos = {0, 0};
+		if (size.x > this->size.x || size.y > this->size.y) {
+			if (rotated == nullptr || turned.x > this->size.x || turned.y > this->size.y) {
+				return false;
+			}
+			turn = true;
+		}
+		// free space found
+		step_range = turn ? turned : size;
+	} else {
+		sf::Vector2i turned_pos;
+		bool found = find(size, pos);
+		if (rotated != nullptr && size.x != size.y && find(turned, turned_pos)
+			&& (!found || turned_pos.y < pos.y || (turned_pos.y == pos.y && turned_pos.x < pos.x))) {
+			// turned rectangle is found earlier
+			pos = turned_pos;
+			found = true;
+			turn = true;
+		}
+		if (!found) {
+			return false;
+		}
+		auto const & placed = turn ? turned : size;
+
+		// recalc step range using gcd per dimension
+		step_range.x = boost::math::gcd(step_range.x, placed.x);
+		step_range.y = boost::math::gcd(step_range.y, placed.y);
+
+		// note: this might speedup generation, but the result won't be perfect anymore
+		step_range.x = std::max(step_range.x, static_cast<int>(min_step.x));
+		step_range.y = std::max(step_range.y, static_cast<int>(min_step.y));
+	}
+
+	// placed at current (top,left)
+	used.add({pos, turn ? turned : size});
+	if (rotated != nullptr) {
+		*rotated = turn;
+	}
+	return true;
+}
+
+void ScanPacker::grow(sf::Vector2u const & size) {
+	this->size = sf::Vector2i{size};
+	used.resize(size);
+}
+
+std::unique_ptr<RectPacker> ScanPacker::clone() const {
+	return std::unique_ptr<RectPacker>{new ScanPacker{*this}};
+}
+
+// ---------------------------------------------------------------------------
+
+MaxRectsPacker::MaxRectsPacker()
+	: size{}
+	, free_rects{} {
+}
+
+std::size_t MaxRectsPacker::split(sf::IntRect const & placed) {
+	std::vector<sf::IntRect> result;
+	result.reserve(free_rects.size() + 4u);
+	for (auto const & rect: free_rects) {
+		if (!rect.intersects(placed)) {
+			result.push_back(rect);
+		}
+	}
+	auto first = result.size();
+	for (auto const & rect: free_rects) {
+		if (!rect.intersects(placed)) {
+			continue;
+		}
+		// keep the parts of the free rectangle around the placed one
+		auto rect_right = rect.left + rect.width;
+		auto rect_bottom = rect.top + rect.height;
+		auto placed_right = placed.left + placed.width;
+		auto placed_bottom = placed.top + placed.height;
+		if (placed.left > rect.left) {
+			result.emplace_back(rect.left, rect.top, placed.left - rect.left, rect.height);
+		}
+		if (placed_right < rect_right) {
+			result.emplace_back(placed_right, rect.top, rect_right - placed_right, rect.height);
+		}
+		if (placed.top > rect.top) {
+			result.emplace_back(rect.left, rect.top, rect.width, placed.top - rect.top);
+		}
+		if (placed_bottom < rect_bottom) {
+			result.emplace_back(rect.left, placed_bottom, rect.width, rect_bottom - placed_bottom);
+		}
+	}
+	free_rects = std::move(result);
+	return first;
+}
+
+void MaxRectsPacker::prune(std::size_t first) {
+	auto contains = [](sf::IntRect const & outer, sf::IntRect const & inner) {
+		return inner.left >= outer.left && inner.top >= outer.top
+			&& inner.left + inner.width <= outer.left + outer.width
+			&& inner.top + inner.height <= outer.top + outer.height;
+	};
+	// only rectangles starting at `first` can be contained in others
+	for (auto i = first; i < free_rects.size(); ++i) {
+		for (std::size_t j = 0u; j < free_rects.size(); ++j) {
+			if (i == j) {
+				continue;
+			}
+			if (contains(free_rects[j], free_rects[i])) {
+				free_rects.erase(free_rects.begin() + i);
+				--i;
+				break;
+			}
+			if (j >= first && contains(free_rects[i], free_rects[j])) {
+				free_rects.erase(free_rects.begin() + j);
+				if (j < i) {
+					--i;
+				}
+				--j;
+			}
+		}
+	}
+}
+
+void MaxRectsPacker::reset(sf::Vector2u const & size) {
+	this->size = sf::Vector2i{size};
+	free_rects.clear();
+	free_rects.emplace_back(0, 0, static_cast<int>(size.x), static_cast<int>(size.y));
+}
+
+bool MaxRectsPacker::insert(sf::Vector2i const & size, sf::Vector2i& pos, bool* rotated) {
+	// find free rectangle with best short side fit
+	auto best_short = std::numeric_limits<int>::max();
+	auto best_long = std::numeric_limits<int>::max();
+	sf::IntRect const * best{nullptr};
+	bool turn{false};
+	auto evaluate = [&](sf::IntRect const & rect, sf::Vector2i const & size, bool turned) {
+		if (rect.width < size.x || rect.height < size.y) {
+			return;
+		}
+		auto leftover_x = rect.width - size.x;
+		auto leftover_y = rect.height - size.y;
+		auto short_side = std::min(leftover_x, leftover_y);
+		auto long_side = std::max(leftover_x, leftover_y);
+		if (short_side < best_short || (short_side == best_short && long_side < best_long)
+			|| (short_side == best_short && long_side == best_long && best != nullptr
+				&& (rect.top < best->top || (rect.top == best->top && rect.left < best->left)))) {
+			best_short = short_side;
+			best_long = long_side;
+			best = &rect;
+			turn = turned;
+		}
+	};
+	for (auto const & rect: free_rects) {
+		evaluate(rect, size, false);
+		if (rotated != nullptr && size.x != size.y) {
+			evaluate(rect, {size.y, size.x}, true);
+		}
+	}
+	if (best == nullptr) {
+		return false;
+	}
+	if (rotated != nullptr) {
+		*rotated = turn;
+	}
+
+	// place at the free rectangle's topleft corner
+	pos = {best->left, best->top};
+	prune(split({pos, turn ? sf::Vector2i{size.y, size.x} : size}));
+	return true;
+}
+
+void MaxRectsPacker::grow(sf::Vector2u const & size) {
+	auto new_size = sf::Vector2i{size};
+	// extend free rectangles reaching the old border
+	for (auto& rect: free_rects) {
+		if (rect.left + rect.width == this->size.x) {
+			rect.width = new_size.x - rect.left;
+		}
+		if (rect.top + rect.height == this->size.y) {
+			rect.height = new_size.y - rect.top;
+		}
+	}
+	// add new area
+	if (new_size.x > this->size.x) {
+		free_rects.emplace_back(this->size.x, 0, new_size.x - this->size.x, new_size.y);
+	}
+	if (new_size.y > this->size.y) {
+		free_rects.emplace_back(0, this->size.y, new_size.x, new_size.y - this->size.y);
+	}
+	this->size = new_size;
+	prune();
+}
+
+void MaxRectsPacker::occupy(sf::IntRect const & rect) {
+	prune(split(rect));
+}
+
+void MaxRectsPacker::release(sf::IntRect const & rect) {
+	free_rects.push_back(rect);
+	prune(free_rects.size() - 1u);
+}
+
+std::unique_ptr<RectPacker> MaxRectsPacker::clone() const {
+	return std::unique_ptr<RectPacker>{new MaxRectsPacker{*this}};
+}
+
+// ---------------------------------------------------------------------------
+
+SkylinePacker::SkylinePacker()
+	: size{}
+	, nodes{} {
+}
+
+int SkylinePacker::fit(std::size_t index, sf::Vector2i const & size) const {
+	auto x = nodes[index].x;
+	if (x + size.x > this->size.x) {
+		return -1;
+	}
+	// rectangle lies on the highest node it spans
+	auto width_left = size.x;
+	auto y = nodes[index].y;
+	while (width_left > 0) {
+		y = std::max(y, nodes[index].y);
+		if (y + size.y > this->size.y) {
+			return -1;
+		}
+		width_left -= nodes[index].width;
+		++index;
+	}
+	return y;
+}
+
+void SkylinePacker::reset(sf::Vector2u const & size) {
+	this->size = sf::Vector2i{size};
+	nodes.clear();
+	nodes.push_back({0, 0, this->size.x});
+}
+
+bool SkylinePacker::insert(sf::Vector2i const & size, sf::Vector2i& pos, bool* rotated) {
+	// find position with lowest bottom edge (tie: narrowest node)
+	auto best_bottom = std::numeric_limits<int>::max();
+	auto best_width = std::numeric_limits<int>::max();
+	auto best_index = nodes.size();
+	sf::Vector2i placed;
+	auto evaluate = [&](std::size_t i, sf::Vector2i const & size) {
+		auto y = fit(i, size);
+		if (y < 0) {
+			return;
+		}
+		auto bottom = y + size.y;
+		if (bottom < best_bottom || (bottom == best_bottom && nodes[i].width < best_width)) {
+			best_bottom = bottom;
+			best_width = nodes[i].width;
+			best_index = i;
+			pos = {nodes[i].x, y};
+			placed = size;
+		}
+	};
+	for (std::size_t i = 0u; i < nodes.size(); ++i) {
+		evaluate(i, size);
+		if (rotated != nullptr && size.x != size.y) {
+			evaluate(i, {size.y, size.x});
+		}
+	}
+	if (best_index == nodes.size()) {
+		return false;
+	}
+	if (rotated != nullptr) {
+		*rotated = (placed != size);
+	}
+
+	// raise skyline
+	nodes.insert(nodes.begin() + best_index, {pos.x, pos.y + placed.y, placed.x});
+	for (auto i = best_index + 1u; i < nodes.size(); ++i) {
+		auto const & prev = nodes[i - 1u];
+		auto prev_right = prev.x + prev.width;
+		if (nodes[i].x >= prev_right) {
+			break;
+		}
+		// cut node shadowed by the new one
+		auto shrink = prev_right - nodes[i].x;
+		nodes[i].x += shrink;
+		nodes[i].width -= shrink;
+		if (nodes[i].width > 0) {
+			break;
+		}
+		nodes.erase(nodes.begin() + i);
+		--i;
+	}
+	// merge neighbours with equal height
+	for (std::size_t i = 0u; i + 1u < nodes.size(); ++i) {
+		if (nodes[i].y == nodes[i + 1u].y) {
+			nodes[i].width += nodes[i + 1u].width;
+			nodes.erase(nodes.begin() + i + 1u);
+			--i;
+		}
+	}
+	return true;
+}
+
+void SkylinePacker::grow(sf::Vector2u const & size) {
+	auto new_size = sf::Vector2i{size};
+	if (new_size.x > this->size.x) {
+		// new area starts at ground level
+		if (nodes.back().y == 0) {
+			nodes.back().width += new_size.x - this->size.x;
+		} else {
+			nodes.push_back({this->size.x, 0, new_size.x - this->size.x});
+		}
+	}
+	this->size = new_size;
+}
+
+std::unique_ptr<RectPacker> SkylinePacker::clone() const {
+	return std::unique_ptr<RectPacker>{new SkylinePacker{*this}};
+}
+
+// ---------------------------------------------------------------------------
+
+GuillotinePacker::GuillotinePacker()
+	: size{}
+	, free_rects{} {
+}
+
+void GuillotinePacker::merge(std::size_t index) {
+	// merge repeatedly until the rectangle has no matching neighbour
+	for (std::size_t j = 0u; j < free_rects.size(); ++j) {
+		if (j == index) {
+			continue;
+		}
+		auto& a = free_rects[index];
+		auto const & b = free_rects[j];
+		bool merged{false};
+		if (a.width == b.width && a.left == b.left) {
+			if (a.top + a.height == b.top) {
+				a.height += b.height;
+				merged = true;
+			} else if (b.top + b.height == a.top) {
+				a.top = b.top;
+				a.height += b.height;
+				merged = true;
+			}
+		} else if (a.height == b.height && a.top == b.top) {
+			if (a.left + a.width == b.left) {
+				a.width += b.width;
+				merged = true;
+			} else if (b.left + b.width == a.left) {
+				a.left = b.left;
+				a.width += b.width;
+				merged = true;
+			}
+		}
+		if (merged) {
+			free_rects.erase(free_rects.begin() + j);
+			if (j < index) {
+				--index;
+			}
+			j = static_cast<std::size_t>(-1);
+		}
+	}
+}
+
+void GuillotinePacker::reset(sf::Vector2u const & size) {
+	this->size = sf::Vector2i{size};
+	free_rects.clear();
+	free_rects.emplace_back(0, 0, static_cast<int>(size.x), static_cast<int>(size.y));
+}
+
+bool GuillotinePacker::insert(sf::Vector2i const & size, sf::Vector2i& pos, bool* rotated) {
+	// find free rectangle with best area fit
+	auto best_area = std::numeric_limits<long>::max();
+	auto best_short = std::numeric_limits<int>::max();
+	auto best_index = free_rects.size();
+	bool turn{false};
+	auto evaluate = [&](std::size_t i, sf::Vector2i const & size, bool turned) {
+		auto const & rect = free_rects[i];
+		if (rect.width < size.x || rect.height < size.y) {
+			return;
+		}
+		auto area = static_cast<long>(rect.width) * rect.height;
+		auto short_side = std::min(rect.width - size.x, rect.height - size.y);
+		bool better{area < best_area};
+		if (area == best_area) {
+			if (i == best_index) {
+				// other orientation inside the same rectangle: prefer shorter leftover side
+				better = short_side < best_short;
+			} else {
+				// tie: prefer topmost, then leftmost
+				auto const & best = free_rects[best_index];
+				better = rect.top < best.top || (rect.top == best.top && rect.left < best.left);
+			}
+		}
+		if (better) {
+			best_area = area;
+			best_short = short_side;
+			best_index = i;
+			turn = turned;
+		}
+	};
+	for (std::size_t i = 0u; i < free_rects.size(); ++i) {
+		evaluate(i, size, false);
+		if (rotated != nullptr && size.x != size.y) {
+			evaluate(i, {size.y, size.x}, true);
+		}
+	}
+	if (best_index == free_rects.size()) {
+		return false;
+	}
+	if (rotated != nullptr) {
+		*rotated = turn;
+	}
+	auto placed = turn ? sf::Vector2i{size.y, size.x} : size;
+
+	// cut along the shorter leftover axis
+	auto rect = free_rects[best_index];
+	free_rects.erase(free_rects.begin() + best_index);
+	pos = {rect.left, rect.top};
+	auto leftover_x = rect.width - placed.x;
+	auto leftover_y = rect.height - placed.y;
+	sf::IntRect right, bottom;
+	if (leftover_x < leftover_y) {
+		right = {rect.left + placed.x, rect.top, leftover_x, placed.y};
+		bottom = {rect.left, rect.top + placed.y, rect.width, leftover_y};
+	} else {
+		right = {rect.left + placed.x, rect.top, leftover_x, rect.height};
+		bottom = {rect.left, rect.top + placed.y, placed.x, leftover_y};
+	}
+	if (right.width > 0 && right.height > 0) {
+		free_rects.push_back(right);
+		merge(free_rects.size() - 1u);
+	}
+	if (bottom.width > 0 && bottom.height > 0) {
+		free_rects.push_back(bottom);
+		merge(free_rects.size() - 1u);
+	}
+	return true;
+}
+
+void GuillotinePacker::grow(sf::Vector2u const & size) {
+	auto new_size = sf::Vector2i{size};
+	// add new area as disjoint rectangles
+	if (new_size.x > this->size.x) {
+		free_rects.emplace_back(this->size.x, 0, new_size.x - this->size.x, new_size.y);
+		merge(free_rects.size() - 1u);
+	}
+	if (new_size.y > this->size.y) {
+		free_rects.emplace_back(0, this->size.y, this->size.x, new_size.y - this->size.y);
+		merge(free_rects.size() - 1u);
+	}
+	this->size = new_size;
+}
+
+std::unique_ptr<RectPacker> GuillotinePacker::clone() const {
+	return std::unique_ptr<RectPacker>{new GuillotinePacker{*this}};
+}
+
+// ---------------------------------------------------------------------------
+
+std::unique_ptr<RectPacker> createPacker(PackingMode mode, sf::Vector2u const & min_step) {
+	switch (mode) {
+		case PackingMode::MaxRects:
+			return std::unique_ptr<RectPacker>{new MaxRectsPacker{}};
+
+		case PackingMode::Skyline:
+			return std::unique_ptr<RectPacker>{new SkylinePacker{}};
+
+		case PackingMode::Guillotine:
+			return std::unique_ptr<RectPacker>{new GuillotinePacker{}};
+
+		case PackingMode::Scan:
+		default:
+			return std::unique_ptr<RectPacker>{new ScanPacker{min_step}};
+	}
+}
+
+} // ::sfext
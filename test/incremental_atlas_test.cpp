@@ -0,0 +1,106 @@
+#include <iostream>
+#include <SFML/Graphics/Image.hpp>
+
+#include <SfmlExt/atlas.hpp>
+
+namespace {
+
+std::size_t num_failures{0u};
+
+void check(bool condition, char const * message) {
+	if (!condition) {
+		std::cerr << "FAILED: " << message << "\n";
+		++num_failures;
+	}
+}
+
+sf::Image create_image(unsigned int width, unsigned int height, sf::Color const & color) {
+	sf::Image image;
+	image.create(width, height, color);
+	return image;
+}
+
+// test whether a frame's pixels have the given color
+bool has_color(sf::Image const & image, sf::IntRect const & rect, sf::Color const & color) {
+	for (auto y = rect.top; y < rect.top + rect.height; ++y) {
+		for (auto x = rect.left; x < rect.left + rect.width; ++x) {
+			if (image.getPixel(x, y) != color) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// hash which groups the keys into few buckets, so the iteration order
+// differs from std::hash
+struct GroupHash {
+	std::size_t operator()(int key) const {
+		return static_cast<std::size_t>(key % 3);
+	}
+};
+
+template <typename HashFunc>
+void fill_and_defragment(sfext::IncrementalAtlas<int, HashFunc>& atlas) {
+	for (auto key = 0; key < 64; ++key) {
+		check(atlas.insert(key, create_image(8u, 8u, sf::Color::Red), {}), "fill atlas with equal frames");
+	}
+	for (auto key = 0; key < 64; key += 3) {
+		atlas.erase(key);
+	}
+	check(atlas.defragment(), "defragment equal frames");
+}
+
+// the defragmented layout does not depend on the hash map's order
+void test_defragment() {
+	sfext::IncrementalAtlas<int> lhs{{64u, 64u}};
+	sfext::IncrementalAtlas<int, GroupHash> rhs{{64u, 64u}};
+	fill_and_defragment(lhs);
+	fill_and_defragment(rhs);
+	bool equal{lhs.getAtlas().frames.size() == rhs.getAtlas().frames.size()};
+	for (auto const & pair: lhs.getAtlas().frames) {
+		auto i = rhs.getAtlas().frames.find(pair.first);
+		equal &= i != rhs.getAtlas().frames.end() && i->second.clipping == pair.second.clipping;
+	}
+	check(equal, "defragment is independent of the hash function");
+}
+
+} // ::anonymous
+
+int main() {
+	sfext::IncrementalAtlas<int> atlas{{64u, 64u}};
+	for (auto key = 0; key < 4; ++key) {
+		check(atlas.insert(key, create_image(32u, 32u, sf::Color::Red), {}), "fill atlas with four frames");
+	}
+	auto const & frames = atlas.getAtlas().frames;
+	auto old = frames.at(0).clipping;
+	
+	// failed replace keeps the old frame
+	atlas.clearDirty();
+	check(!atlas.insert(0, create_image(48u, 48u, sf::Color::Blue), {}), "oversized replacement fails");
+	check(frames.count(0) == 1u && frames.at(0).clipping == old, "old frame keeps its area");
+	check(has_color(atlas.getAtlas().image, old, sf::Color::Red), "old frame keeps its pixels");
+	
+	// replace inside the full atlas reuses the old frame's area
+	check(atlas.insert(0, create_image(32u, 32u, sf::Color::Blue), {}), "replacement fits into old area");
+	check(frames.at(0).clipping == old, "replacement uses old area");
+	check(has_color(atlas.getAtlas().image, old, sf::Color::Blue), "replacement pixels are copied");
+	
+	// other frames are untouched
+	for (auto key = 1; key < 4; ++key) {
+		check(has_color(atlas.getAtlas().image, frames.at(key).clipping, sf::Color::Red), "other frames keep their pixels");
+	}
+	check(!atlas.insert(4, create_image(1u, 1u, sf::Color::Red), {}), "atlas is still full");
+	
+	// shrinking replacement frees space
+	check(atlas.insert(1, create_image(16u, 16u, sf::Color::Green), {}), "smaller replacement fits");
+	check(atlas.insert(4, create_image(16u, 16u, sf::Color::Green), {}), "freed space is reused");
+	
+	test_defragment();
+	
+	if (num_failures > 0u) {
+		std::cerr << num_failures << " check(s) failed\n";
+		return 1;
+	}
+	std::cout << "all checks passed\n";
+}
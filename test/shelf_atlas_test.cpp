@@ -0,0 +1,107 @@
+#include <iostream>
+#include <SFML/Graphics/Image.hpp>
+
+#include <SfmlExt/shelf_atlas.hpp>
+
+namespace {
+
+std::size_t num_failures{0u};
+
+void check(bool condition, char const * message) {
+	if (!condition) {
+		std::cerr << "FAILED: " << message << "\n";
+		++num_failures;
+	}
+}
+
+sf::Image create_image(unsigned int width, unsigned int height, sf::Color const & color) {
+	sf::Image image;
+	image.create(width, height, color);
+	return image;
+}
+
+// test whether all pixels inside a rectangle have the given color
+bool has_color(sf::Image const & image, sf::IntRect const & rect, sf::Color const & color) {
+	for (auto y = rect.top; y < rect.top + rect.height; ++y) {
+		for (auto x = rect.left; x < rect.left + rect.width; ++x) {
+			if (image.getPixel(x, y) != color) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void test_lru() {
+	// four 32x32 frames fill the atlas
+	sfext::ShelfAtlas<int> atlas{{64u, 64u}};
+	for (auto key = 0; key < 4; ++key) {
+		check(atlas.insert(key, create_image(32u, 32u, sf::Color::Red), {}) != nullptr, "frames fit");
+	}
+	check(atlas.getStats().insertions == 4u && atlas.getStats().evictions == 0u, "no evictions while space is left");
+	
+	// use frames 0 and 2, so 1 is the least recently used one
+	check(atlas.find(0) != nullptr && atlas.find(2) != nullptr, "frames are found");
+	check(atlas.find(9) == nullptr, "missing frame is not found");
+	check(atlas.getStats().hits == 2u && atlas.getStats().misses == 1u, "lookups are counted");
+	
+	check(atlas.insert(4, create_image(32u, 32u, sf::Color::Green), {}) != nullptr, "frame fits after eviction");
+	check(atlas.getStats().evictions == 1u, "one frame is evicted");
+	check(atlas.find(1) == nullptr, "least recently used frame is evicted");
+	check(atlas.find(3) != nullptr, "more recently inserted frame is kept");
+	
+	// frames 0, 2 and 4 (least recently used first) are evicted until a shelf is empty
+	check(atlas.insert(5, create_image(64u, 32u, sf::Color::Green), {}) != nullptr, "wide frame fits after evictions");
+	check(atlas.getStats().evictions == 4u, "evictions are counted");
+	check(atlas.find(0) == nullptr && atlas.find(2) == nullptr && atlas.find(4) == nullptr,
+		"least recently used frames are evicted first");
+	check(atlas.find(3) != nullptr && atlas.getNumFrames() == 2u, "most recently used frame is kept");
+	
+	atlas.resetStats();
+	check(atlas.getStats().hits == 0u && atlas.getStats().evictions == 0u, "statistics are reset");
+}
+
+void test_failed_replace() {
+	sfext::ShelfAtlas<int> atlas{{64u, 64u}};
+	check(atlas.insert(0, create_image(4u, 4u, sf::Color::Red), {}) != nullptr, "small frame fits");
+	auto old = atlas.find(0)->clipping;
+	check(atlas.insert(0, create_image(300u, 10u, sf::Color::Blue), {}) == nullptr, "oversized replacement fails");
+	auto frame = atlas.find(0);
+	check(frame != nullptr && frame->clipping == old, "old frame is kept");
+	check(has_color(atlas.getImage(), old, sf::Color::Red), "old frame keeps its pixels");
+	check(atlas.getStats().insertions == 1u, "failed insertion is not counted");
+}
+
+void test_stale_pixels() {
+	// put a lower frame onto a shelf where a higher frame was erased
+	sfext::ShelfAtlas<int> atlas{{32u, 32u}};
+	check(atlas.insert(0, create_image(16u, 32u, sf::Color::Red), {}) != nullptr, "first frame fits");
+	check(atlas.insert(1, create_image(16u, 32u, sf::Color::Red), {}) != nullptr, "second frame fits");
+	check(atlas.erase(1), "second frame is erased");
+	atlas.clearDirty();
+	check(atlas.insert(2, create_image(16u, 24u, sf::Color::Green), {}) != nullptr, "lower frame reuses the shelf");
+	auto frame = atlas.find(2);
+	check(frame != nullptr && frame->clipping == sf::IntRect(16, 0, 16, 24), "lower frame replaces the erased one");
+	if (frame != nullptr) {
+		auto const & rect = frame->clipping;
+		check(has_color(atlas.getImage(), rect, sf::Color::Green), "frame pixels are copied");
+		sf::IntRect below{rect.left, rect.top + rect.height, rect.width, 32 - rect.height};
+		check(has_color(atlas.getImage(), below, sf::Color::Transparent), "pixels below the frame are cleared");
+		auto dirty = atlas.getDirtyRect();
+		check(dirty.top <= below.top && dirty.top + dirty.height >= below.top + below.height, "cleared rows are dirty");
+	}
+}
+
+} // ::anonymous
+
+int main() {
+	test_lru();
+	test_failed_replace();
+	test_stale_pixels();
+	
+	if (num_failures > 0u) {
+		std::cerr << num_failures << " check(s) failed\n";
+		return 1;
+	}
+	std::cout << "all checks passed\n";
+}
@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+#include <SFML/Graphics/View.hpp>
+
+#include <SfmlExt/tiling.hpp>
+
+namespace {
+
+std::size_t num_failures{0u};
+
+void check(bool condition, char const * message) {
+	if (!condition) {
+		std::cerr << "FAILED: " << message << "\n";
+		++num_failures;
+	}
+}
+
+using TileSet = std::set<std::pair<int, int>>;
+
+// determine corners of the (rotated) view
+void get_corners(sf::View const & view, sf::Vector2f corners[4]) {
+	auto angle = view.getRotation() * 3.14159265f / 180.f;
+	auto cosine = std::cos(angle);
+	auto sine = std::sin(angle);
+	auto half = view.getSize() / 2.f;
+	sf::Vector2f const local[4] = {{-half.x, -half.y}, {half.x, -half.y}, {half.x, half.y}, {-half.x, half.y}};
+	for (int i = 0; i < 4; ++i) {
+		corners[i].x = view.getCenter().x + cosine * local[i].x - sine * local[i].y;
+		corners[i].y = view.getCenter().y + sine * local[i].x + cosine * local[i].y;
+	}
+}
+
+// test whether the projections of two convex quads onto the other's edge normals overlap
+bool overlaps_on_axes(sf::Vector2f const * lhs, sf::Vector2f const * rhs) {
+	for (int i = 0; i < 4; ++i) {
+		auto edge = lhs[(i + 1) % 4] - lhs[i];
+		sf::Vector2f normal{-edge.y, edge.x};
+		float lhs_min{1e30f}, lhs_max{-1e30f}, rhs_min{1e30f}, rhs_max{-1e30f};
+		for (int j = 0; j < 4; ++j) {
+			auto a = lhs[j].x * normal.x + lhs[j].y * normal.y;
+			auto b = rhs[j].x * normal.x + rhs[j].y * normal.y;
+			lhs_min = std::min(lhs_min, a);
+			lhs_max = std::max(lhs_max, a);
+			rhs_min = std::min(rhs_min, b);
+			rhs_max = std::max(rhs_max, b);
+		}
+		if (lhs_max <= rhs_min || rhs_max <= lhs_min) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// visible tiles by testing each tile's padded bounding box against the view
+template <sfext::GridMode M>
+TileSet brute_force(sfext::Tiling<M> const & tiling, sf::View const & view, unsigned int padding) {
+	sf::Vector2f corners[4];
+	get_corners(view, corners);
+	auto tile_size = tiling.getTileSize();
+	sf::Vector2f half{tile_size.x / 2.f + padding * tile_size.x, tile_size.y / 2.f + padding * tile_size.y};
+	auto center = tiling.fromScreen(view.getCenter());
+	auto radius = static_cast<int>(std::hypot(view.getSize().x, view.getSize().y) / std::min(tile_size.x, tile_size.y))
+		+ static_cast<int>(padding) + 2;
+	TileSet result;
+	for (auto y = static_cast<int>(center.y) - radius; y <= static_cast<int>(center.y) + radius; ++y) {
+		for (auto x = static_cast<int>(center.x) - radius; x <= static_cast<int>(center.x) + radius; ++x) {
+			auto pos = tiling.toScreen({static_cast<float>(x), static_cast<float>(y)});
+			sf::Vector2f const box[4] = {{pos.x - half.x, pos.y - half.y}, {pos.x + half.x, pos.y - half.y},
+				{pos.x + half.x, pos.y + half.y}, {pos.x - half.x, pos.y + half.y}};
+			if (overlaps_on_axes(box, corners) && overlaps_on_axes(corners, box)) {
+				result.insert({x, y});
+			}
+		}
+	}
+	return result;
+}
+
+template <sfext::GridMode M>
+void test_spans(char const * name, sf::Vector2f const & tile_size, unsigned int padding) {
+	sfext::Tiling<M> tiling{tile_size};
+	tiling.setPadding({padding, padding});
+	std::mt19937 rng{2u};
+	std::vector<sfext::TileSpan> spans;
+	std::size_t num_mismatches{0u}, num_duplicates{0u}, num_unsorted{0u}, num_uncovered{0u};
+	for (auto i = 0u; i < 100u; ++i) {
+		sf::View view{{static_cast<float>(3000u + rng() % 3000u), static_cast<float>(3000u + rng() % 3000u)},
+			{static_cast<float>(100u + rng() % 1500u), static_cast<float>(100u + rng() % 1000u)}};
+		if (i % 5u != 0u) {
+			view.setRotation(static_cast<float>(rng() % 360u));
+		}
+		if (i % 3u == 0u) {
+			view.zoom(0.5f + (rng() % 300u) / 100.f);
+		}
+		tiling.setView(view);
+		tiling.getSpans(spans);
+		
+		// count visited tiles
+		TileSet visited;
+		std::size_t num_visited{0u};
+		for (std::size_t j = 0u; j < spans.size(); ++j) {
+			if (j > 0u && spans[j].row <= spans[j - 1u].row) {
+				++num_unsorted;
+			}
+			for (auto x = spans[j].x_begin; x < spans[j].x_end; ++x) {
+				auto tile = sfext::Tiling<M>::getTile(spans[j], x);
+				visited.insert({tile.x, tile.y});
+				++num_visited;
+			}
+		}
+		if (num_visited != visited.size()) {
+			++num_duplicates;
+		}
+		auto expected = brute_force(tiling, view, padding);
+		if (visited != expected) {
+			++num_mismatches;
+			std::cerr << name << ": view " << i << " visits " << visited.size() << " tiles, expected "
+				<< expected.size() << "\n";
+		}
+		
+		// iteration covers all visible tiles (even if rotated)
+		TileSet iterated;
+		for (auto const & pos: tiling) {
+			iterated.insert({static_cast<int>(pos.x), static_cast<int>(pos.y)});
+		}
+		if (!std::includes(iterated.begin(), iterated.end(), expected.begin(), expected.end())) {
+			++num_uncovered;
+		}
+	}
+	check(num_mismatches == 0u, "spans visit exactly the visible tiles");
+	check(num_duplicates == 0u, "spans do not visit tiles twice");
+	check(num_unsorted == 0u, "spans are sorted by row");
+	check(num_uncovered == 0u, "iteration covers the visible tiles");
+}
+
+// collect the tiles of all spans
+template <sfext::GridMode M>
+TileSet get_tiles(std::vector<sfext::TileSpan> const & spans) {
+	TileSet result;
+	for (auto const & span: spans) {
+		for (auto x = span.x_begin; x < span.x_end; ++x) {
+			auto tile = sfext::Tiling<M>::getTile(span, x);
+			result.insert({tile.x, tile.y});
+		}
+	}
+	return result;
+}
+
+template <sfext::GridMode M>
+void test_delta(sf::Vector2f const & tile_size, unsigned int padding) {
+	sfext::Tiling<M> tiling{tile_size};
+	tiling.setPadding({padding, padding});
+	std::mt19937 rng{3u};
+	std::uniform_real_distribution<float> offset{-25.f, 25.f};
+	std::vector<sfext::TileSpan> previous_spans, current_spans, entered, left;
+	std::size_t num_mismatches{0u}, num_oversized{0u};
+	for (auto i = 0u; i < 100u; ++i) {
+		sf::View previous{{static_cast<float>(3000u + rng() % 3000u), static_cast<float>(3000u + rng() % 3000u)},
+			{static_cast<float>(100u + rng() % 1500u), static_cast<float>(100u + rng() % 1000u)}};
+		if (i % 2u == 0u) {
+			previous.setRotation(static_cast<float>(rng() % 360u));
+		}
+		auto current = previous;
+		current.move(offset(rng), offset(rng));
+		if (i % 3u == 0u) {
+			current.setRotation(current.getRotation() + offset(rng) / 5.f);
+		}
+		if (i % 5u == 0u) {
+			current.zoom(1.1f);
+		}
+		tiling.setView(previous);
+		tiling.getSpans(previous_spans);
+		tiling.setView(current);
+		tiling.getSpans(current_spans);
+		tiling.getDelta(previous, entered, left);
+		
+		// compare with the set differences of the visible tiles
+		auto before = get_tiles<M>(previous_spans);
+		auto after = get_tiles<M>(current_spans);
+		TileSet expected_entered, expected_left;
+		std::set_difference(after.begin(), after.end(), before.begin(), before.end(),
+			std::inserter(expected_entered, expected_entered.end()));
+		std::set_difference(before.begin(), before.end(), after.begin(), after.end(),
+			std::inserter(expected_left, expected_left.end()));
+		if (get_tiles<M>(entered) != expected_entered || get_tiles<M>(left) != expected_left) {
+			++num_mismatches;
+		}
+		// at most two spans per row and list
+		if (entered.size() > 2u * current_spans.size() || left.size() > 2u * previous_spans.size()) {
+			++num_oversized;
+		}
+	}
+	check(num_mismatches == 0u, "delta equals the set differences of the visible tiles");
+	check(num_oversized == 0u, "delta yields at most two spans per row");
+}
+
+} // ::anonymous
+
+int main() {
+	test_spans<sfext::GridMode::Orthogonal>("ortho", {64.f, 48.f}, 0u);
+	test_spans<sfext::GridMode::Orthogonal>("ortho padded", {32.f, 32.f}, 1u);
+	test_spans<sfext::GridMode::IsoDiamond>("iso", {64.f, 32.f}, 0u);
+	test_spans<sfext::GridMode::IsoDiamond>("iso padded", {64.f, 32.f}, 1u);
+	test_delta<sfext::GridMode::Orthogonal>({64.f, 48.f}, 0u);
+	test_delta<sfext::GridMode::Orthogonal>({32.f, 32.f}, 1u);
+	test_delta<sfext::GridMode::IsoDiamond>({64.f, 32.f}, 0u);
+	test_delta<sfext::GridMode::IsoDiamond>({64.f, 32.f}, 1u);
+	
+	if (num_failures > 0u) {
+		std::cerr << num_failures << " check(s) failed\n";
+		return 1;
+	}
+	std::cout << "all checks passed\n";
+}